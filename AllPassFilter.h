@@ -10,8 +10,10 @@
 
 #define AllPassFilter_h
 #pragma once
-#include "CircularBufferShort.h"
+#include "CircularBuffer.h"
 #include "LFO.h"
+#include "LFOBank.h"
+#include "Denormals.h"
 
 class AllPassFilter {
 public:
@@ -20,10 +22,11 @@ public:
     }
 
     /**
-    An allpass filter with a given delay length and feedback/forward gains
+    An allpass filter with a given delay length and feedback/forward gains.
+    The delay memory is taken from the arena if one is given.
     */
-    AllPassFilter(unsigned int length, float feedbackGain, float feedForwardGain){
-        buffer.setLengthSamples(length);
+    AllPassFilter(unsigned int length, float feedbackGain, float feedForwardGain, DelayArena* arena = nullptr)
+        : buffer ((int) length, 0, arena) {
         delay = length;
         this->feedbackGain = feedbackGain;
         this->feedForwardGain = feedForwardGain;
@@ -34,8 +37,9 @@ public:
     plus given modulation rate (in Hz) and size (in samples).
     */
     AllPassFilter(unsigned int length, float feedbackGain, float feedForwardGain,
-                  float lfoFreq, float lfoSizeSamples, int sampleRate = 44100, float phase = 0){
-        buffer.setLengthSamples(length);
+                  float lfoFreq, float lfoSizeSamples, int sampleRate = 44100, float phase = 0,
+                  DelayArena* arena = nullptr)
+        : buffer ((int) length, (unsigned int) ceil(lfoSizeSamples), arena) {
         delay = length;
         this->feedbackGain = feedbackGain;
         this->feedForwardGain = feedForwardGain;
@@ -43,7 +47,7 @@ public:
         lfo.setfrequency(lfoFreq); // modulation rate
         lfo.setRange(0, 1);
         lfo.setPhase(phase);
-        buffer.setSampleRate(sampleRate);
+        lfo.setSampleRate(sampleRate);
         buffer.setModRange(lfoSizeSamples); // modulation range
         
         isModulated = true;
@@ -56,15 +60,121 @@ public:
      Returns the next sample.
      */
     inline float processSample(float sample) {
-        if(isModulated) {
+        if(isModulated && bank != nullptr) {
+            buffer.mapReadHeadMod(bank->getValue(bankLane));
+        }
+        else if(isModulated && modulationInterval > 1) {
+            float out;
+            processBlock(&sample, &out, 1);
+            return out;
+        }
+        else if(isModulated) {
             lfo.next();
             buffer.mapReadHeadMod(lfo.getValue());
         }
         float next = buffer.getSample();
-        buffer.pushSample(sample + (next * feedbackGain));
+        buffer.pushSample(flushDenormal(sample + (next * feedbackGain)));
         return next + (sample * feedForwardGain);
     }
     
+    /**
+     Process a block of samples through the filter.
+     The modulation check and gains are resolved once per block.
+     in and out may point to the same buffer.
+     */
+    inline void processBlock(const float* in, float* out, int numSamples) {
+        const float fbGain = feedbackGain;
+        const float ffGain = feedForwardGain;
+        
+        if(isModulated && bank != nullptr) {
+            // ramp to the lane's value (for the end of this block) across the block
+            processRamp(in, out, numSamples, buffer.mapModulation(bank->getValue(bankLane)), fbGain, ffGain);
+        }
+        else if(isModulated && modulationInterval > 1) {
+            processControlRate(in, out, numSamples, fbGain, ffGain);
+        }
+        else if(isModulated) {
+            for(int i = 0; i < numSamples; i++) {
+                lfo.next();
+                buffer.mapReadHeadMod(lfo.getValue());
+                const float sample = in[i];
+                float next = buffer.getSample();
+                buffer.pushSample(flushDenormal(sample + (next * fbGain)));
+                out[i] = next + (sample * ffGain);
+            }
+        }
+        else {
+            // fixed delay: work directly on the delay memory
+            buffer.processSpans(numSamples, [&](const float* delayed, float* write, int offset, int n) {
+                const float* x = in + offset;
+                float* y = out + offset;
+                for(int i = 0; i < n; i++) {
+                    const float sample = x[i];
+                    const float next = delayed[i];
+                    write[i] = flushDenormal(sample + (next * fbGain));
+                    y[i] = next + (sample * ffGain);
+                }
+            });
+        }
+    }
+    
+    /**
+     Process a block of samples through the filter in place.
+     */
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+    
+    /**
+     Evaluates the LFO only every numSamples samples and ramps the
+     delay modulation linearly in between (1, the default, evaluates
+     it every sample). Chorus-rate LFOs barely move in 16 or 32
+     samples, so this saves most of the LFO cost in e.g. reverbs
+     with many modulated allpasses.
+     */
+    inline void setModulationInterval(int numSamples) {
+        jassert(numSamples > 0);
+        modulationInterval = numSamples;
+        rampRemaining = 0;
+    }
+    
+    inline int getModulationInterval() {
+        return modulationInterval;
+    }
+    
+    /**
+     Makes the filter take its modulation from a lane of a shared
+     LFOBank, in place of its own LFO. The owner processes the bank
+     once per block, before the filters; processBlock then ramps the
+     delay modulation to the lane's value across the block, and
+     processSample follows the lane directly (so process the bank per
+     sample for per-sample modulation). A lane left at its default
+     range gives the same modulation as the filter's own LFO.
+     Pass nullptr to go back to the filter's own LFO.
+     */
+    inline void setModulationSource(const LFOBank* newBank, int lane = 0) {
+        jassert(isModulated); // only the modulated constructor sets a modulation range
+        jassert(newBank == nullptr || (lane >= 0 && lane < newBank->getNumLanes()));
+        bank = newBank;
+        bankLane = lane;
+    }
+    
+    /**
+     Sets the waveform of the modulation LFO, e.g. LFO::SMOOTH_RANDOM
+     for random modulation.
+     */
+    inline void setModulationType(LFO::Oscillator type) {
+        lfo.setType(type);
+    }
+    
+    /**
+     Seeds the random modulation modes. Each filter has a seed of
+     its own by default, so their random modulation is uncorrelated.
+     */
+    inline void setModulationSeed(uint32_t seed) {
+        lfo.setSeed(seed);
+    }
+    
     /**
      Taps the delay line at a given sample.
      */
@@ -104,7 +214,7 @@ public:
     
 private:
     // standard allpass fields
-    CircularBufferShort buffer { 1 }; // default length of 1
+    PALdsp::CircularBuffer<> buffer { 1 }; // default length of 1
     unsigned int delay;
     float feedForwardGain;
     float feedbackGain;
@@ -112,4 +222,46 @@ private:
     // modulated allpass fields
     LFO lfo;
     bool isModulated = false;
+    const LFOBank* bank = nullptr; // shared modulation source, if set
+    int bankLane = 0;
+    int modulationInterval = 1; // samples between LFO evaluations
+    int rampRemaining = 0; // samples left before rampTarget is reached
+    float rampTarget = 0; // read head offset at the next LFO evaluation
+    
+    /**
+     The modulated block loop at control rate: the LFO is moved on a
+     whole interval at a time and the read head offset ramps to each
+     new value inside the delay line's read kernel. A ramp can be
+     split across blocks.
+     */
+    inline void processControlRate(const float* in, float* out, int numSamples, float fbGain, float ffGain) {
+        int done = 0;
+        while(done < numSamples) {
+            if(rampRemaining == 0) {
+                lfo.advance(modulationInterval);
+                rampTarget = buffer.mapModulation(lfo.getValue());
+                rampRemaining = modulationInterval;
+            }
+            const int n = std::min(rampRemaining, numSamples - done);
+            const float current = buffer.getReadHeadModulation();
+            const float target = (n == rampRemaining)
+                ? rampTarget
+                : current + (rampTarget - current) * (float) n / (float) rampRemaining;
+            
+            processRamp(in + done, out + done, n, target, fbGain, ffGain);
+            rampRemaining -= n;
+            done += n;
+        }
+    }
+    
+    /**
+     Runs numSamples with the delay modulation ramping to target.
+     */
+    inline void processRamp(const float* in, float* out, int numSamples, float target, float fbGain, float ffGain) {
+        buffer.processModulated(numSamples, target, [&](float next, int i) {
+            const float sample = in[i];
+            out[i] = next + (sample * ffGain);
+            return flushDenormal(sample + (next * fbGain));
+        });
+    }
 };
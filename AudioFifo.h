@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    AudioFifo.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A lock-free single-producer / single-consumer FIFO of samples, for
+    passing audio between the realtime thread and a worker or metering
+    thread. One thread may only write and one other thread may only read;
+    neither ever blocks, allocates or makes a system call.
+
+    Storage is a DelayMemory (a power-of-two size, optionally from a
+    DelayArena), indexed with the same wire-anded masking as the circular
+    buffers. The read and write counters are free-running atomics, each
+    on its own cache line together with its owner's cached copy of the
+    other counter, so the two threads only touch each other's line when
+    the cached value says the FIFO looks full (or empty).
+
+    Bulk transfers are at most two memcpys; prepareWrite/prepareRead give
+    the same two spans for zero-copy use:
+
+        auto spans = fifo.prepareWrite(n); // fill spans.first, spans.second
+        fifo.finishWrite(spans.first.size + spans.second.size);
+
+    For several channels, interleave them or use one FIFO per channel.
+
+  ==============================================================================
+*/
+
+#ifndef AudioFifo_h
+#define AudioFifo_h
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include "DelayMemory.h"
+#include "CircularBuffer.h"
+
+class AudioFifo {
+public:
+
+    /**
+     Creates a FIFO that can hold at least minCapacity samples
+     (rounded up to a power of two).
+     Allocates, so construct it off the audio thread.
+     */
+    AudioFifo(int minCapacity, DelayArena* arena = nullptr)
+        : buffer (minCapacity - 1, arena) {
+        jassert(minCapacity > 0 && minCapacity <= (1 << 30));
+    }
+
+    ~AudioFifo(){};
+
+    AudioFifo(const AudioFifo&) = delete;
+    AudioFifo& operator=(const AudioFifo&) = delete;
+
+    inline int getCapacity() {
+        return buffer.getSize();
+    }
+
+    /**
+     Number of samples the consumer can read right now.
+     */
+    inline int getNumReady() {
+        return (int) (writer.index.load(std::memory_order_acquire)
+                    - reader.index.load(std::memory_order_relaxed));
+    }
+
+    /**
+     Number of samples the producer can write right now.
+     */
+    inline int getFreeSpace() {
+        return buffer.getSize() - (int) (writer.index.load(std::memory_order_relaxed)
+                                       - reader.index.load(std::memory_order_acquire));
+    }
+
+    //==============================================================================
+    // producer side
+
+    /**
+     Writes up to numSamples (as many as fit) and returns how many were written.
+     */
+    int write(const float* data, int numSamples) {
+        const PALdsp::DelaySpans spans = prepareWrite(numSamples);
+        memcpy(spans.first.data, data, spans.first.size * sizeof(float));
+        memcpy(spans.second.data, data + spans.first.size, spans.second.size * sizeof(float));
+        const int written = spans.first.size + spans.second.size;
+        finishWrite(written);
+        return written;
+    }
+
+    /**
+     Returns the space for up to numSamples (limited to the free
+     space) as at most two spans. Call finishWrite once filled.
+     */
+    PALdsp::DelaySpans prepareWrite(int numSamples) {
+        const uint32_t w = writer.index.load(std::memory_order_relaxed);
+        const int size = buffer.getSize();
+        if((int) (w - writer.cachedOther) + numSamples > size) {
+            // only look at the reader's line when we seem to be short of space
+            writer.cachedOther = reader.index.load(std::memory_order_acquire);
+        }
+        const int n = std::max(0, std::min(numSamples, size - (int) (w - writer.cachedOther)));
+        return getSpans(w, n);
+    }
+
+    /**
+     Publishes numSamples written through prepareWrite to the consumer.
+     */
+    inline void finishWrite(int numSamples) {
+        const uint32_t w = writer.index.load(std::memory_order_relaxed);
+        writer.index.store(w + (uint32_t) numSamples, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // consumer side
+
+    /**
+     Reads up to numSamples (as many as are ready) and returns how many were read.
+     */
+    int read(float* out, int numSamples) {
+        const PALdsp::DelaySpans spans = prepareRead(numSamples);
+        memcpy(out, spans.first.data, spans.first.size * sizeof(float));
+        memcpy(out + spans.first.size, spans.second.data, spans.second.size * sizeof(float));
+        const int numRead = spans.first.size + spans.second.size;
+        finishRead(numRead);
+        return numRead;
+    }
+
+    /**
+     Returns up to numSamples of ready samples (limited to what has
+     been written) as at most two spans. Call finishRead once used.
+     */
+    PALdsp::DelaySpans prepareRead(int numSamples) {
+        const uint32_t r = reader.index.load(std::memory_order_relaxed);
+        if((int) (reader.cachedOther - r) < numSamples) {
+            // only look at the writer's line when we seem to be short of samples
+            reader.cachedOther = writer.index.load(std::memory_order_acquire);
+        }
+        const int n = std::max(0, std::min(numSamples, (int) (reader.cachedOther - r)));
+        return getSpans(r, n);
+    }
+
+    /**
+     Frees numSamples read through prepareRead for the producer.
+     */
+    inline void finishRead(int numSamples) {
+        const uint32_t r = reader.index.load(std::memory_order_relaxed);
+        reader.index.store(r + (uint32_t) numSamples, std::memory_order_release);
+    }
+
+    /**
+     Empties the FIFO. Only call this while neither thread is using it.
+     */
+    void reset() {
+        writer.index.store(0);
+        writer.cachedOther = 0;
+        reader.index.store(0);
+        reader.cachedOther = 0;
+    }
+
+private:
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "AudioFifo needs lock-free 32-bit atomics");
+
+    /**
+     A counter owned by one thread, plus that thread's last
+     seen value of the other thread's counter.
+     */
+    struct alignas(64) Side {
+        std::atomic<uint32_t> index { 0 };
+        uint32_t cachedOther = 0;
+    };
+
+    DelayMemory buffer;
+    Side writer;
+    Side reader;
+
+    inline PALdsp::DelaySpans getSpans(uint32_t position, int numSamples) {
+        const int start = (int) (position & (uint32_t) buffer.getMask());
+        const int firstSize = std::min(numSamples, buffer.getSize() - start);
+        return { { buffer.getData() + start, firstSize },
+                 { buffer.getData(), numSamples - firstSize } };
+    }
+};
+
+
+#endif /* AudioFifo_h */
@@ -28,18 +28,8 @@ public:
     
     BPF(type filterType, float frequency, float Q, float wet = 1, float dry = 0) : Biquad (filterType, frequency, wet, dry) {
 
-        // audio-eq-cookbook
-        double w0 = 2 * (frequency/44100) * PI;
-        double cosW0 = cos(w0);
-        double sinW0 = sin(w0);
-        double alpha = sinW0 / (Q * 2);
-
-        b0 = alpha;
-        b1 = 0;
-        b2 = -1 * alpha;
-        a0 = 1 + alpha;
-        a1 = -2 * cosW0;
-        a2 = 1 - alpha;
+        this->Q = Q;
+        updateCoefficients();
     }
     
     inline float processSample(float samp){
@@ -49,10 +39,25 @@ public:
         else return 0.0f;
     }
 
+    using Biquad::processBlock;
+
+    void processBlock(const float* in, float* out, int numSamples) override {
+        if(filterType == BIQUAD) {
+            Biquad::processBlock(in, out, numSamples);
+        }
+        else std::fill_n(out, numSamples, 0.0f);
+    }
+
     void setType(int newType) {
         filterType = newType;
     }
 
+protected:
+    BiquadCoefficients designCoefficients() const override {
+        // audio-eq-cookbook
+        return BiquadCoefficients::bandpass(freq, Q, sampleRate);
+    }
+
 private:
 
 };
@@ -0,0 +1,357 @@
+/*
+  ==============================================================================
+
+    BandLimitedOscillator.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    An LFO that can also run at audio rate (FM, ring modulation, or as
+    a plain oscillator) without aliasing. It has the same interface as
+    LFO, and its values follow LFO's conventions (sine from -1 to 1, the
+    other waveforms from 0 to 1, then mapped to the range), so it can
+    replace one in code written against that interface (or a template
+    parameter). It isn't an LFO& though: LFO's methods aren't virtual,
+    so through one it would give the naive waveforms. It builds on
+    LFO privately and passes the controls through instead.
+
+    Sine, triangle, saw and square are read from mip-mapped wavetables:
+    each octave of fundamental frequency has its own table, holding
+    only the harmonics that stay below Nyquist at the top of that
+    octave. The table level is picked from the frequency once per
+    block and the tables are read four samples at a time, linearly
+    interpolated.
+
+    Saw and square can instead use PolyBLEP (setEngine(POLYBLEP)): the
+    naive waveform with a polynomial correction around each step. It
+    needs no tables and has no jumps between table levels when the
+    frequency sweeps, at the cost of more aliasing in the top octaves.
+
+    The tables (about 250 KB, shared by every oscillator) are built by
+    the first constructor, so construct oscillators off the audio
+    thread.
+
+  ==============================================================================
+*/
+
+#ifndef BandLimitedOscillator_h
+#define BandLimitedOscillator_h
+
+#include <vector>
+#include "LFO.h"
+#include "RealFFT.h"
+
+class BandLimitedOscillator : protected LFO {
+public:
+    using LFO::Oscillator;
+
+    enum Engine {
+        WAVETABLE,
+        POLYBLEP
+    };
+
+    /**
+     Creates a sine-wave oscillator at 1Hz and 44.1kHz.
+     */
+    BandLimitedOscillator() : LFO () {}
+
+    /**
+     Creates a sine-wave oscillator at 1Hz.
+     */
+    BandLimitedOscillator(int sampleRate) : LFO (sampleRate) {}
+
+    /**
+     Creates a sine-wave oscillator with a custom frequency (in Hz).
+     */
+    BandLimitedOscillator(int sampleRate, float frequency) : LFO (sampleRate, frequency) {}
+
+    /**
+     Creates a custom-wave oscillator with a custom frequency (in Hz).
+     */
+    BandLimitedOscillator(int sampleRate, float frequency, LFO::Oscillator osc)
+        : LFO (sampleRate, frequency, osc) {}
+
+    /**
+     Creates a custom-wave oscillator with a custom frequency (in Hz),
+     mapped to the range min - max.
+     */
+    BandLimitedOscillator(int sampleRate, float frequency, LFO::Oscillator osc, float min, float max)
+        : LFO (sampleRate, frequency, osc, min, max) {}
+
+    ~BandLimitedOscillator(){};
+
+    /**
+     Chooses wavetables or PolyBLEP for the saw and square waves
+     (sine and triangle always use the wavetables).
+     */
+    inline void setEngine(Engine newEngine) {
+        engine = newEngine;
+    }
+
+    inline Engine getEngine() {
+        return engine;
+    }
+
+    // the controls are LFO's (advance too: the waveforms only read the phase)
+    using LFO::setType;
+    using LFO::setfrequency;
+    using LFO::setSampleRate;
+    using LFO::setRange;
+    using LFO::setPhase;
+    using LFO::getPhase;
+    using LFO::setSeed;
+    using LFO::advance;
+
+    /**
+     Get the value at the current point of the cycle.
+     */
+    inline float getValue(float phase = 0) {
+        uint64_t offset = phaseOffset;
+        if(phaseVal == 0) {
+            jassert(phase <= 1 && phase >= 0);
+            offset = (phase > 1 || phase < 0) ? 0 : toFixedPoint(phase);
+        }
+        const float progress = toProgress(currProgress + offset);
+
+        switch (currOscillator) {
+            case Oscillator::SINE:
+                return TableShape { tables->sine.data() }.process(progress);
+            case Oscillator::TRIANGLE:
+                return TableShape { tables->get(Oscillator::TRIANGLE, getTableLevel()) }.process(progress);
+            case Oscillator::SQUARE:
+                if(engine == POLYBLEP) return BlepSquareShape (getIncrement()).process(progress);
+                return TableShape { tables->get(Oscillator::SQUARE, getTableLevel()) }.process(progress);
+            case Oscillator::SAW:
+                if(engine == POLYBLEP) return BlepSawShape (getIncrement()).process(progress);
+                return TableShape { tables->get(Oscillator::SAW, getTableLevel()) }.process(progress);
+            default:
+                return LFO::getValue(phase);
+        }
+    }
+
+    /**
+     Generates and returns the next sample value.
+     */
+    inline float next() {
+        if(currOscillator >= Oscillator::RANDOM) return LFO::next(); // random modes
+        currProgress += increment;
+        return jmap(getValue(), min, max);
+    }
+
+    /**
+     Generates the next numSamples values (mapped to the range) into
+     out, as that many calls to next() would. The waveform, engine
+     and table level are resolved once for the block.
+     */
+    inline void nextBlock(float* out, int numSamples) {
+        switch (currOscillator) {
+            case Oscillator::SINE:
+                generate(out, numSamples, TableShape { tables->sine.data() });
+                break;
+            case Oscillator::TRIANGLE:
+                generate(out, numSamples, TableShape { tables->get(Oscillator::TRIANGLE, getTableLevel()) });
+                break;
+            case Oscillator::SQUARE:
+                if(engine == POLYBLEP) generate(out, numSamples, BlepSquareShape (getIncrement()));
+                else generate(out, numSamples, TableShape { tables->get(Oscillator::SQUARE, getTableLevel()) });
+                break;
+            case Oscillator::SAW:
+                if(engine == POLYBLEP) generate(out, numSamples, BlepSawShape (getIncrement()));
+                else generate(out, numSamples, TableShape { tables->get(Oscillator::SAW, getTableLevel()) });
+                break;
+            default:
+                LFO::nextBlock(out, numSamples);
+        }
+    }
+
+private:
+    static constexpr int tableSize = 2048;
+    static constexpr int maxHarmonics = tableSize / 4; // in the lowest table
+    static constexpr int numLevels = 10; // maxHarmonics halves per level, down to 1
+
+    /**
+     The shared wavetables: one sine, plus numLevels band-limited
+     tables each for triangle, saw and square. Every table has one
+     guard sample (a copy of the first) for interpolation.
+     */
+    struct Wavetables {
+        std::vector<float> sine;
+        std::vector<float> levels[3][numLevels];
+
+        Wavetables() {
+            RealFFT fft (tableSize);
+            std::vector<float> re (tableSize / 2 + 1), im (tableSize / 2 + 1);
+            const float amplitude = tableSize / 2.0f; // bin value of a unit sinusoid
+
+            // sin(2 pi p), as LFO's sine
+            std::fill(re.begin(), re.end(), 0.0f);
+            std::fill(im.begin(), im.end(), 0.0f);
+            im[1] = -amplitude;
+            sine = synthesise(fft, re, im);
+
+            for(int level = 0; level < numLevels; level++) {
+                const int harmonics = maxHarmonics >> level;
+                for(int shape = 0; shape < 3; shape++) {
+                    std::fill(re.begin(), re.end(), 0.0f);
+                    std::fill(im.begin(), im.end(), 0.0f);
+                    re[0] = 0.5f * tableSize; // the waveforms run 0 - 1
+                    for(int k = 1; k <= harmonics; k++) {
+                        // Fourier series of the 0 - 1 waveforms
+                        if(shape == 0 && k % 2 == 1) {
+                            re[k] = -amplitude * (float) (4.0 / (PI * PI * k * k)); // triangle
+                        }
+                        else if(shape == 1) {
+                            im[k] = amplitude * (float) (1.0 / (PI * k)); // saw
+                        }
+                        else if(shape == 2 && k % 2 == 1) {
+                            im[k] = -amplitude * (float) (2.0 / (PI * k)); // square
+                        }
+                    }
+                    levels[shape][level] = synthesise(fft, re, im);
+                }
+            }
+        }
+
+        inline const float* get(int oscillator, int level) const {
+            const int shape = (oscillator == Oscillator::TRIANGLE) ? 0 : (oscillator == Oscillator::SAW) ? 1 : 2;
+            return levels[shape][level].data();
+        }
+
+        static std::vector<float> synthesise(RealFFT& fft, const std::vector<float>& re, const std::vector<float>& im) {
+            std::vector<float> table (tableSize + 1);
+            fft.performInverse(re.data(), im.data(), table.data());
+            table[tableSize] = table[0];
+            return table;
+        }
+    };
+
+    static const Wavetables& getTables() {
+        static const Wavetables wavetables;
+        return wavetables;
+    }
+
+    const Wavetables* tables = &getTables();
+    Engine engine = WAVETABLE;
+
+    /**
+     Picks the table with the most harmonics that all stay below
+     Nyquist at the current frequency: level k holds maxHarmonics >> k,
+     fine while increment <= 2^-(10 - k) cycles per sample.
+     */
+    inline int getTableLevel() const {
+        int level = 0;
+        while(level < numLevels - 1 && increment > ((uint64_t) 1 << (54 + level))) level++;
+        return level;
+    }
+
+    /** The phase increment in cycles per sample. */
+    inline float getIncrement() const {
+        return (float) ((double) increment * (1.0 / 18446744073709551616.0));
+    }
+
+    /**
+     Linearly interpolated lookup into one tableSize + 1 table.
+     */
+    struct TableShape {
+        const float* table;
+
+        inline float process(float p) const {
+            const float position = p * (float) tableSize;
+            const int index = (int) position;
+            const float frac = position - (float) index;
+            return table[index] + frac * (table[index + 1] - table[index]);
+        }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 process(__m128 p) const {
+            const __m128 position = _mm_mul_ps(p, _mm_set1_ps((float) tableSize));
+            const __m128i index = _mm_cvttps_epi32(position);
+            const __m128 frac = _mm_sub_ps(position, _mm_cvtepi32_ps(index));
+            // (scalar loads beat AVX2 gathers here)
+            alignas(16) int i[4];
+            _mm_store_si128((__m128i*) i, index);
+            const __m128 x0 = _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+            const __m128 x1 = _mm_setr_ps(table[i[0] + 1], table[i[1] + 1], table[i[2] + 1], table[i[3] + 1]);
+            return _mm_add_ps(x0, _mm_mul_ps(frac, _mm_sub_ps(x1, x0)));
+        }
+#endif
+    };
+
+    /**
+     The PolyBLEP residual for a unit step at phase 0, where dt is
+     the increment: a 2-sample polynomial blend either side of it.
+     */
+    struct Blep {
+        float dt, invDt;
+
+        Blep(float increment) : dt (std::min(increment, 0.5f)), invDt (1.0f / std::min(increment, 0.5f)) {}
+
+        inline float residual(float t) const {
+            if(t < dt) {
+                const float x = t * invDt - 1.0f;
+                return -(x * x);
+            }
+            if(t > 1.0f - dt) {
+                const float x = (t - 1.0f) * invDt + 1.0f;
+                return x * x;
+            }
+            return 0;
+        }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 residual(__m128 t) const {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 vDt = _mm_set1_ps(dt);
+            const __m128 vInvDt = _mm_set1_ps(invDt);
+            const __m128 x0 = _mm_sub_ps(_mm_mul_ps(t, vInvDt), one);
+            const __m128 x1 = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(t, one), vInvDt), one);
+            const __m128 start = _mm_and_ps(_mm_cmplt_ps(t, vDt), _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(x0, x0)));
+            const __m128 end = _mm_and_ps(_mm_cmpgt_ps(t, _mm_sub_ps(one, vDt)), _mm_mul_ps(x1, x1));
+            return _mm_or_ps(start, end);
+        }
+#endif
+    };
+
+    /**
+     PolyBLEP saw, 0 - 1 (a half-size step at the wrap).
+     */
+    struct BlepSawShape {
+        Blep blep;
+
+        BlepSawShape(float increment) : blep (increment) {}
+
+        inline float process(float p) const {
+            return p - 0.5f * blep.residual(p);
+        }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 process(__m128 p) const {
+            return _mm_sub_ps(p, _mm_mul_ps(_mm_set1_ps(0.5f), blep.residual(p)));
+        }
+#endif
+    };
+
+    /**
+     PolyBLEP square, 0 - 1: up at the wrap, down half way.
+     */
+    struct BlepSquareShape {
+        Blep blep;
+
+        BlepSquareShape(float increment) : blep (increment) {}
+
+        inline float process(float p) const {
+            const float half = (p >= 0.5f) ? p - 0.5f : p + 0.5f;
+            const float naive = (p < 0.5f) ? 1.0f : 0.0f;
+            return naive + 0.5f * (blep.residual(p) - blep.residual(half));
+        }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 process(__m128 p) const {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 vHalf = _mm_set1_ps(0.5f);
+            const __m128 secondHalf = _mm_cmpge_ps(p, vHalf);
+            const __m128 half = _mm_sub_ps(_mm_add_ps(p, vHalf), _mm_and_ps(secondHalf, one));
+            const __m128 naive = _mm_andnot_ps(secondHalf, one);
+            return _mm_add_ps(naive, _mm_mul_ps(vHalf, _mm_sub_ps(blep.residual(p), blep.residual(half))));
+        }
+#endif
+    };
+};
+
+
+#endif /* BandLimitedOscillator_h */
@@ -13,53 +13,143 @@
 */
 
 #include "filter.h"
+#include "BiquadCoefficients.h"
+#include "BiquadCore.h"
 
 #ifndef Biquad_h
 #define Biquad_h
 #include <math.h>
+#include <algorithm>
 
 class Biquad : public filter {
 public:
     
+    // The engine every cookbook subclass runs on. Defaults to double precision
+    // direct form I (the original arithmetic); define PALDSP_BIQUAD_SAMPLE_TYPE
+    // and/or PALDSP_BIQUAD_TOPOLOGY for the whole project to change it, as
+    // they change this class's layout (see BiquadCore.h).
+    typedef BiquadCore<PALDSP_BIQUAD_SAMPLE_TYPE, PALDSP_BIQUAD_TOPOLOGY> Core;
+    typedef PALDSP_BIQUAD_SAMPLE_TYPE SampleType;
+    
     Biquad(int lfoType, float frequency, float wet = 1, float dry = 0) : filter(lfoType, frequency, wet, dry){}
 
     virtual ~Biquad() {}
     
     inline float processSample(float samp){
-        
-        // calculate result
-        double result = ((b0 / a0) * samp) +
-                        ((b1 / a0) * a1Delay) +
-                        ((b2 / a0) * a2Delay) -
-                        ((a1 / a0) * b1Delay) -
-                        ((a2 / a0) * b2Delay);
-
-        // update delay register
-        a2Delay = a1Delay;
-        a1Delay = samp;
-        b2Delay = b1Delay;
-        b1Delay = result;
-
+        if(coefficientsDirty) updateCoefficients();
+        SampleType result = core.processSample(samp);
         return (float) ((result * wet) + (samp * dry));
     }
 
+    using filter::processBlock;
+
+    /**
+     Processes a block of samples through the biquad.
+     Any pending parameter change is applied first, then the wet/dry
+     gains are loaded once per block; output is identical
+     to calling processSample() on each sample in turn.
+     */
+    void processBlock(const float* in, float* out, int numSamples) override {
+        if(coefficientsDirty) updateCoefficients();
+
+        const float wetGain = wet;
+        const float dryGain = dry;
+
+        for(int i = 0; i < numSamples; i++) {
+            const float samp = in[i];
+            SampleType result = core.processSample(samp);
+            out[i] = (float) ((result * wetGain) + (samp * dryGain));
+        }
+
+        core.flushState();
+    }
+
     virtual void setType(int newType) = 0;
 
+    /**
+     Sets the sample rate the coefficients are designed for.
+     The new coefficients are calculated at the start of the next block.
+     */
+    void prepare(double newSampleRate) override {
+        sampleRate = newSampleRate;
+        coefficientsDirty = true;
+    }
+
+    /**
+     Sets the cutoff/centre frequency in Hz.
+     The new coefficients are calculated at the start of the next block,
+     so this is cheap enough to call for every automation change.
+     */
+    void setFrequency(float frequency) {
+        freq = frequency;
+        coefficientsDirty = true;
+    }
+
+    /**
+     Sets the Q (resonance/bandwidth) of the filter.
+     Applied at the start of the next block.
+     */
+    void setQ(float newQ) {
+        Q = newQ;
+        coefficientsDirty = true;
+    }
+
+    /**
+     Sets the gain in dB (used by ParamEQBand and the shelf filters).
+     Applied at the start of the next block.
+     */
+    void setGain(float newDbGain) {
+        dbGain = newDbGain;
+        coefficientsDirty = true;
+    }
+
+    float getFrequency() { return freq; }
+    float getQ() { return Q; }
+    float getGain() { return dbGain; }
+
+    /**
+     Recalculates the coefficients from the current frequency, Q, gain
+     and sample rate. Called automatically by processSample/processBlock
+     after a setter, but can be called directly (e.g. from prepareToPlay).
+     */
+    void updateCoefficients() {
+        setCoefficients(designCoefficients());
+        coefficientsDirty = false;
+    }
+
+    /**
+     Sets the (un-normalised) coefficients of this biquad.
+     They are normalised once here rather than on every sample.
+     */
+    void setCoefficients(const BiquadCoefficients& c) {
+        coefficients = c;
+        core.setCoefficients(c);
+    }
+
+    /**
+     Returns the (un-normalised) coefficients of this biquad,
+     e.g. for loading the same design into a BiquadBank lane.
+     */
+    BiquadCoefficients getCoefficients() const {
+        return coefficients;
+    }
+
     void reset() {
-        a1Delay = 0;
-        a2Delay = 0;
-        b1Delay = 0;
-        b2Delay = 0;
+        core.reset();
     }
     
 protected:
-    // coefficients
-    double a0 = 0, a1 = 0, a2 = 0, b0 = 0, b1 = 0, b2 = 0;
-    // delay registers
-    double a1Delay = 0;
-    double a2Delay = 0;
-    double b1Delay = 0;
-    double b2Delay = 0;
+    BiquadCoefficients coefficients;
+    Core core;
+    float Q = 0.7071f;
+    float dbGain = 0;
+    bool coefficientsDirty = false;
+
+    /**
+     Returns the cookbook coefficients for the current frequency, Q,
+     gain and sample rate. Implemented by each filter type.
+     */
+    virtual BiquadCoefficients designCoefficients() const = 0;
 };
 
 
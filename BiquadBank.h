@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    BiquadBank.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A bank of N independent biquads (one per channel or band) with their
+    coefficients and state stored as contiguous structure-of-arrays lanes.
+    Lanes are processed 8 at a time with AVX or 4 at a time with SSE,
+    falling back to plain scalar code elsewhere.
+
+    Each lane runs transposed direct form II in single precision, with
+    coefficients normalised once when they are set. Any cookbook design
+    (LPF, HPF, BPF, NotchFilter, ParamEQBand, the shelves) can be loaded
+    into a lane via BiquadCoefficients or an existing Biquad object.
+
+  ==============================================================================
+*/
+
+#ifndef BiquadBank_h
+#define BiquadBank_h
+
+#include <vector>
+#include <algorithm>
+#include "Biquad.h"
+#include "BiquadCoefficients.h"
+#include "Denormals.h"
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define PALDSP_BIQUADBANK_SSE 1
+#endif
+
+class BiquadBank {
+public:
+
+    /**
+     Creates a bank of numLanes biquads, each initialised as a passthrough.
+     All memory is allocated here, so construct it off the audio thread.
+     */
+    BiquadBank(int numLanes) {
+        jassert(numLanes > 0);
+        this->numLanes = numLanes;
+        // pad the lane count so every SIMD group is full
+        laneStride = ((numLanes + laneWidth - 1) / laneWidth) * laneWidth;
+
+        b0.assign(laneStride, 0.0f);
+        b1.assign(laneStride, 0.0f);
+        b2.assign(laneStride, 0.0f);
+        a1.assign(laneStride, 0.0f);
+        a2.assign(laneStride, 0.0f);
+        z1.assign(laneStride, 0.0f);
+        z2.assign(laneStride, 0.0f);
+        scratch.assign(laneStride * chunkSize, 0.0f);
+
+        for(int lane = 0; lane < numLanes; lane++) {
+            b0[lane] = 1.0f;
+        }
+    }
+
+    ~BiquadBank(){};
+
+    /**
+     Loads a set of cookbook coefficients into a lane.
+     The coefficients are normalised by a0 here, not per sample.
+     */
+    inline void setLane(int lane, const BiquadCoefficients& coefficients) {
+        jassert(lane >= 0 && lane < numLanes);
+        BiquadCoefficients c = coefficients.normalised();
+        b0[lane] = (float) c.b0;
+        b1[lane] = (float) c.b1;
+        b2[lane] = (float) c.b2;
+        a1[lane] = (float) c.a1;
+        a2[lane] = (float) c.a2;
+    }
+
+    /**
+     Loads the design of an existing biquad (LPF, ParamEQBand etc.) into a lane.
+     */
+    inline void setLane(int lane, const Biquad& design) {
+        setLane(lane, design.getCoefficients());
+    }
+
+    /**
+     Loads the same coefficients into every lane.
+     */
+    inline void setAllLanes(const BiquadCoefficients& coefficients) {
+        for(int lane = 0; lane < numLanes; lane++) {
+            setLane(lane, coefficients);
+        }
+    }
+
+    /**
+     Clears the state of every lane.
+     */
+    inline void reset() {
+        std::fill(z1.begin(), z1.end(), 0.0f);
+        std::fill(z2.begin(), z2.end(), 0.0f);
+    }
+
+    inline int getNumLanes() {
+        return numLanes;
+    }
+
+    /**
+     Processes one buffer per lane, in place.
+     @param channels Array of numLanes channel pointers.
+     @param numSamples The number of samples in each channel.
+     */
+    inline void processBlock(float* const* channels, int numSamples) {
+        for(int start = 0; start < numSamples; start += chunkSize) {
+            const int n = std::min(chunkSize, numSamples - start);
+
+            for(int i = 0; i < n; i++) {
+                float* frame = &scratch[i * laneStride];
+                for(int lane = 0; lane < numLanes; lane++) {
+                    frame[lane] = channels[lane][start + i];
+                }
+            }
+
+            processFrames(scratch.data(), n);
+
+            for(int i = 0; i < n; i++) {
+                const float* frame = &scratch[i * laneStride];
+                for(int lane = 0; lane < numLanes; lane++) {
+                    channels[lane][start + i] = frame[lane];
+                }
+            }
+        }
+    }
+
+    /**
+     Processes interleaved audio in place
+     (data[frame * numLanes + lane]).
+     */
+    inline void processInterleaved(float* data, int numFrames) {
+        if(laneStride == numLanes) {
+            processFrames(data, numFrames);
+            return;
+        }
+
+        for(int start = 0; start < numFrames; start += chunkSize) {
+            const int n = std::min(chunkSize, numFrames - start);
+            for(int i = 0; i < n; i++) {
+                std::copy_n(data + (start + i) * numLanes, numLanes, &scratch[i * laneStride]);
+            }
+            processFrames(scratch.data(), n);
+            for(int i = 0; i < n; i++) {
+                std::copy_n(&scratch[i * laneStride], numLanes, data + (start + i) * numLanes);
+            }
+        }
+    }
+
+    /**
+     Runs the same input through every lane, e.g. for a bank
+     of parallel bandpass filters.
+     @param in The input signal.
+     @param bandOut Array of numLanes output buffers.
+     @param numSamples The number of samples to process.
+     */
+    inline void processBands(const float* in, float* const* bandOut, int numSamples) {
+        for(int start = 0; start < numSamples; start += chunkSize) {
+            const int n = std::min(chunkSize, numSamples - start);
+
+            for(int i = 0; i < n; i++) {
+                std::fill_n(&scratch[i * laneStride], laneStride, in[start + i]);
+            }
+
+            processFrames(scratch.data(), n);
+
+            for(int i = 0; i < n; i++) {
+                const float* frame = &scratch[i * laneStride];
+                for(int lane = 0; lane < numLanes; lane++) {
+                    bandOut[lane][start + i] = frame[lane];
+                }
+            }
+        }
+    }
+
+private:
+#if defined(__AVX__)
+    static constexpr int laneWidth = 8;
+#elif defined(PALDSP_BIQUADBANK_SSE)
+    static constexpr int laneWidth = 4;
+#else
+    static constexpr int laneWidth = 1;
+#endif
+    static constexpr int chunkSize = 64; // frames transposed per pass
+
+    int numLanes;
+    int laneStride; // numLanes rounded up to a multiple of laneWidth
+
+    // structure-of-arrays coefficients (normalised) and state
+    std::vector<float> b0, b1, b2, a1, a2;
+    std::vector<float> z1, z2;
+    std::vector<float> scratch;
+
+    /**
+     Filters numFrames frames in place, each frame holding laneStride lanes.
+     Loops lane-group outer, sample inner, so a group's coefficients and
+     state stay in registers for the whole block.
+     */
+    inline void processFrames(float* frames, int numFrames) {
+        for(int g = 0; g < laneStride; g += laneWidth) {
+#if defined(__AVX__)
+            const __m256 vb0 = _mm256_loadu_ps(&b0[g]);
+            const __m256 vb1 = _mm256_loadu_ps(&b1[g]);
+            const __m256 vb2 = _mm256_loadu_ps(&b2[g]);
+            const __m256 va1 = _mm256_loadu_ps(&a1[g]);
+            const __m256 va2 = _mm256_loadu_ps(&a2[g]);
+            __m256 s1 = _mm256_loadu_ps(&z1[g]);
+            __m256 s2 = _mm256_loadu_ps(&z2[g]);
+
+            for(int i = 0; i < numFrames; i++) {
+                float* frame = frames + i * laneStride + g;
+                const __m256 x = _mm256_loadu_ps(frame);
+                const __m256 y = _mm256_add_ps(_mm256_mul_ps(vb0, x), s1);
+                s1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(vb1, x), _mm256_mul_ps(va1, y)), s2);
+                s2 = _mm256_sub_ps(_mm256_mul_ps(vb2, x), _mm256_mul_ps(va2, y));
+                _mm256_storeu_ps(frame, y);
+            }
+
+            _mm256_storeu_ps(&z1[g], s1);
+            _mm256_storeu_ps(&z2[g], s2);
+#elif defined(PALDSP_BIQUADBANK_SSE)
+            const __m128 vb0 = _mm_loadu_ps(&b0[g]);
+            const __m128 vb1 = _mm_loadu_ps(&b1[g]);
+            const __m128 vb2 = _mm_loadu_ps(&b2[g]);
+            const __m128 va1 = _mm_loadu_ps(&a1[g]);
+            const __m128 va2 = _mm_loadu_ps(&a2[g]);
+            __m128 s1 = _mm_loadu_ps(&z1[g]);
+            __m128 s2 = _mm_loadu_ps(&z2[g]);
+
+            for(int i = 0; i < numFrames; i++) {
+                float* frame = frames + i * laneStride + g;
+                const __m128 x = _mm_loadu_ps(frame);
+                const __m128 y = _mm_add_ps(_mm_mul_ps(vb0, x), s1);
+                s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vb1, x), _mm_mul_ps(va1, y)), s2);
+                s2 = _mm_sub_ps(_mm_mul_ps(vb2, x), _mm_mul_ps(va2, y));
+                _mm_storeu_ps(frame, y);
+            }
+
+            _mm_storeu_ps(&z1[g], s1);
+            _mm_storeu_ps(&z2[g], s2);
+#else
+            const float cb0 = b0[g], cb1 = b1[g], cb2 = b2[g];
+            const float ca1 = a1[g], ca2 = a2[g];
+            float s1 = z1[g], s2 = z2[g];
+
+            for(int i = 0; i < numFrames; i++) {
+                float* frame = frames + i * laneStride + g;
+                const float x = *frame;
+                const float y = (cb0 * x) + s1;
+                s1 = (cb1 * x) - (ca1 * y) + s2;
+                s2 = (cb2 * x) - (ca2 * y);
+                *frame = y;
+            }
+
+            z1[g] = s1;
+            z2[g] = s2;
+#endif
+        }
+
+        // flush decayed state once per block rather than per sample
+        for(int lane = 0; lane < laneStride; lane++) {
+            z1[lane] = flushDenormal(z1[lane]);
+            z2[lane] = flushDenormal(z2[lane]);
+        }
+    }
+};
+
+
+#endif /* BiquadBank_h */
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    BiquadCoefficients.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Plain set of biquad coefficients, plus the cookbook designs used by
+    LPF, HPF, BPF, NotchFilter, ParamEQBand and the shelf filters.
+    Keeping the designs here lets other engines (e.g. BiquadBank) share them.
+    Equations from: Audio EQ Cookbook
+    https://webaudio.github.io/Audio-EQ-Cookbook/audio-eq-cookbook.html
+
+  ==============================================================================
+*/
+
+#ifndef BiquadCoefficients_h
+#define BiquadCoefficients_h
+#include <math.h>
+
+#ifndef PI
+#define PI      3.14159265358979323846
+#endif
+
+struct BiquadCoefficients {
+
+    // un-normalised cookbook coefficients (defaults to a passthrough)
+    double b0 = 1, b1 = 0, b2 = 0, a0 = 1, a1 = 0, a2 = 0;
+
+    /**
+     Returns a copy of these coefficients divided through by a0.
+     */
+    inline BiquadCoefficients normalised() const {
+        BiquadCoefficients c;
+        c.b0 = b0 / a0;
+        c.b1 = b1 / a0;
+        c.b2 = b2 / a0;
+        c.a0 = 1;
+        c.a1 = a1 / a0;
+        c.a2 = a2 / a0;
+        return c;
+    }
+
+    static BiquadCoefficients lowpass(float frequency, float Q, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+
+        c.b0 = (1 - cosW0) / 2;
+        c.b1 = 1 - cosW0;
+        c.b2 = (1 - cosW0) / 2;
+        c.a0 = 1 + alpha;
+        c.a1 = -2 * cosW0;
+        c.a2 = 1 - alpha;
+        return c;
+    }
+
+    static BiquadCoefficients highpass(float frequency, float Q, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+
+        c.b0 = (1 + cosW0) / 2;
+        c.b1 = -1 * (1 + cosW0);
+        c.b2 = (1 + cosW0) / 2;
+        c.a0 = 1 + alpha;
+        c.a1 = -2 * cosW0;
+        c.a2 = 1 - alpha;
+        return c;
+    }
+
+    /**
+     Bandpass with a constant 0dB peak gain.
+     */
+    static BiquadCoefficients bandpass(float frequency, float Q, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+
+        c.b0 = alpha;
+        c.b1 = 0;
+        c.b2 = -1 * alpha;
+        c.a0 = 1 + alpha;
+        c.a1 = -2 * cosW0;
+        c.a2 = 1 - alpha;
+        return c;
+    }
+
+    static BiquadCoefficients notch(float frequency, float Q, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+
+        c.b0 = 1;
+        c.b1 = -2 * cosW0;
+        c.b2 = 1;
+        c.a0 = 1 + alpha;
+        c.a1 = -2 * cosW0;
+        c.a2 = 1 - alpha;
+        return c;
+    }
+
+    static BiquadCoefficients peaking(float frequency, float Q, float dbGain, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+        double A = pow(10.0, dbGain/40);
+
+        c.b0 = 1 + (alpha * A);
+        c.b1 = -2 * cosW0;
+        c.b2 = 1 - (alpha * A);
+        c.a0 = 1 + (alpha / A);
+        c.a1 = -2 * cosW0;
+        c.a2 = 1 - (alpha / A);
+        return c;
+    }
+
+    static BiquadCoefficients lowShelf(float frequency, float Q, float dbGain, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+        double A = pow(10.0, dbGain/40);
+
+        c.b0 = A * ((A + 1) - ((A - 1) * cosW0) + (2 * sqrt(A) * alpha));
+        c.b1 = 2 * A * ((A - 1) - ((A + 1) * cosW0));
+        c.b2 = A * ((A + 1) - ((A - 1) * cosW0) - (2 * sqrt(A) * alpha));
+        c.a0 = (A + 1) + ((A - 1) * cosW0) + (2 * sqrt(A) * alpha);
+        c.a1 = -2 * ((A - 1) + ((A + 1) * cosW0));
+        c.a2 = (A + 1) + ((A - 1) * cosW0) - (2 * sqrt(A) * alpha);
+        return c;
+    }
+
+    static BiquadCoefficients highShelf(float frequency, float Q, float dbGain, double sampleRate = 44100) {
+        BiquadCoefficients c;
+        double w0 = 2 * (frequency/(float) sampleRate) * PI;
+        double cosW0 = cos(w0);
+        double sinW0 = sin(w0);
+        double alpha = sinW0 / (Q * 2);
+        double A = pow(10.0, dbGain/40);
+
+        c.b0 = A * ((A + 1) + ((A - 1) * cosW0) + (2 * sqrt(A) * alpha));
+        c.b1 = -2 * A * ((A - 1) + ((A + 1) * cosW0));
+        c.b2 = A * ((A + 1) + ((A - 1) * cosW0) - (2 * sqrt(A) * alpha));
+        c.a0 = (A + 1) - ((A - 1) * cosW0) + (2 * sqrt(A) * alpha);
+        c.a1 = 2 * ((A - 1) - ((A + 1) * cosW0));
+        c.a2 = (A + 1) - ((A - 1) * cosW0) - (2 * sqrt(A) * alpha);
+        return c;
+    }
+};
+
+
+#endif /* BiquadCoefficients_h */
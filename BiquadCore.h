@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    BiquadCore.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    The sample-processing engine underneath Biquad.
+    - Coefficients are normalised by a0 once, when they are set.
+    - The topology is chosen at compile time:
+        DirectForm1            - the original Biquad arithmetic
+        TransposedDirectForm2  - two state registers, fewest operations
+        Lattice                - Gray-Markel lattice-ladder, well behaved
+                                 at low frequencies and in single precision
+    - Storage and arithmetic precision is a template parameter
+      (float or double).
+
+    Biquad, its cookbook subclasses and the static filters run on the
+    engine chosen by PALDSP_BIQUAD_SAMPLE_TYPE and PALDSP_BIQUAD_TOPOLOGY.
+    They don't take the engine as a template parameter, so their layout
+    and code depend on the macros: set them project-wide (compiler
+    flags, or the Projucer's preprocessor definitions), never just
+    before one #include, or different translation units get different
+    classes of the same name (an ODR violation the linker won't catch by
+    itself). A mismatch fails to link with MSVC, and elsewhere trips an
+    assertion at startup in debug builds.
+
+  ==============================================================================
+*/
+
+#ifndef BiquadCore_h
+#define BiquadCore_h
+
+#include <type_traits>
+#include "BiquadCoefficients.h"
+#include "Denormals.h"
+
+namespace BiquadTopology {
+    struct DirectForm1 {};
+    struct TransposedDirectForm2 {};
+    struct Lattice {};
+}
+
+// Engine used by Biquad, its cookbook subclasses and the static filters;
+// define these for the whole project to change precision/topology (see above).
+#ifndef PALDSP_BIQUAD_SAMPLE_TYPE
+ #define PALDSP_BIQUAD_SAMPLE_TYPE double
+#endif
+
+#ifndef PALDSP_BIQUAD_TOPOLOGY
+ #define PALDSP_BIQUAD_TOPOLOGY BiquadTopology::DirectForm1
+#endif
+
+template <typename SampleType = double, typename Topology = BiquadTopology::TransposedDirectForm2>
+class BiquadCore {
+public:
+
+    static_assert(std::is_floating_point<SampleType>::value,
+                  "BiquadCore needs a float or double sample type");
+
+    BiquadCore() {}
+
+    BiquadCore(const BiquadCoefficients& coefficients) {
+        setCoefficients(coefficients);
+    }
+
+    /**
+     Sets new coefficients, normalising them by a0.
+     The filter state is kept, so this can be called between blocks.
+     */
+    inline void setCoefficients(const BiquadCoefficients& coefficients) {
+        const double nb0 = coefficients.b0 / coefficients.a0;
+        const double nb1 = coefficients.b1 / coefficients.a0;
+        const double nb2 = coefficients.b2 / coefficients.a0;
+        const double na1 = coefficients.a1 / coefficients.a0;
+        const double na2 = coefficients.a2 / coefficients.a0;
+
+        if constexpr (std::is_same<Topology, BiquadTopology::Lattice>::value) {
+            // reflection coefficients
+            const double k2 = na2;
+            const double k1 = na1 / (1 + na2);
+            // ladder (tap) coefficients
+            const double v2 = nb2;
+            const double v1 = nb1 - (na1 * v2);
+            const double v0 = nb0 - (k1 * v1) - (na2 * v2);
+
+            c0 = (SampleType) k1;
+            c1 = (SampleType) k2;
+            c2 = (SampleType) v0;
+            c3 = (SampleType) v1;
+            c4 = (SampleType) v2;
+        }
+        else {
+            c0 = (SampleType) nb0;
+            c1 = (SampleType) nb1;
+            c2 = (SampleType) nb2;
+            c3 = (SampleType) na1;
+            c4 = (SampleType) na2;
+        }
+    }
+
+    /**
+     Clears the filter state.
+     */
+    inline void reset() {
+        s0 = 0;
+        s1 = 0;
+        s2 = 0;
+        s3 = 0;
+    }
+
+    /**
+     Flushes any subnormal values in the state registers to zero.
+     Called at the end of each block, so a decaying tail costs at most
+     one slow block before the filter settles at exactly zero.
+     */
+    inline void flushState() {
+        s0 = flushDenormal(s0);
+        s1 = flushDenormal(s1);
+        s2 = flushDenormal(s2);
+        s3 = flushDenormal(s3);
+    }
+
+    /**
+     Processes a sample through the filter.
+     */
+    inline SampleType processSample(SampleType x) {
+        return tick(x, c0, c1, c2, c3, c4, s0, s1, s2, s3);
+    }
+
+    /**
+     Processes a block of samples through the filter.
+     Coefficients and state are held in locals for the whole loop.
+     in and out may point to the same buffer.
+     */
+    inline void processBlock(const float* in, float* out, int numSamples) {
+        const SampleType k0 = c0, k1 = c1, k2 = c2, k3 = c3, k4 = c4;
+        SampleType r0 = s0, r1 = s1, r2 = s2, r3 = s3;
+
+        for(int i = 0; i < numSamples; i++) {
+            out[i] = (float) tick((SampleType) in[i], k0, k1, k2, k3, k4, r0, r1, r2, r3);
+        }
+
+        s0 = flushDenormal(r0);
+        s1 = flushDenormal(r1);
+        s2 = flushDenormal(r2);
+        s3 = flushDenormal(r3);
+    }
+
+private:
+    // normalised coefficients, meaning depends on topology:
+    // DF1/TDF2: b0, b1, b2, a1, a2
+    // Lattice:  k1, k2, v0, v1, v2
+    SampleType c0 = 1, c1 = 0, c2 = 0, c3 = 0, c4 = 0;
+    // state registers (TDF2 and Lattice only use the first two)
+    SampleType s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+    static inline SampleType tick(SampleType x,
+                                  SampleType k0, SampleType k1, SampleType k2, SampleType k3, SampleType k4,
+                                  SampleType& r0, SampleType& r1, SampleType& r2, SampleType& r3) {
+
+        if constexpr (std::is_same<Topology, BiquadTopology::DirectForm1>::value) {
+            // r0/r1 = input delays, r2/r3 = output delays
+            SampleType y = (k0 * x) +
+                           (k1 * r0) +
+                           (k2 * r1) -
+                           (k3 * r2) -
+                           (k4 * r3);
+            r1 = r0;
+            r0 = x;
+            r3 = r2;
+            r2 = y;
+            return y;
+        }
+        else if constexpr (std::is_same<Topology, BiquadTopology::TransposedDirectForm2>::value) {
+            SampleType y = (k0 * x) + r0;
+            r0 = (k1 * x) - (k3 * y) + r1;
+            r1 = (k2 * x) - (k4 * y);
+            return y;
+        }
+        else {
+            static_assert(std::is_same<Topology, BiquadTopology::Lattice>::value,
+                          "Unknown biquad topology");
+            // r0 = g0[n-1], r1 = g1[n-1]
+            SampleType f1 = x - (k1 * r1);
+            SampleType f0 = f1 - (k0 * r0);
+            SampleType g2 = (k1 * f1) + r1;
+            SampleType g1 = (k0 * f0) + r0;
+            r1 = g1;
+            r0 = f0;
+            return (k2 * f0) + (k3 * g1) + (k4 * g2);
+        }
+    }
+};
+
+namespace BiquadEngineCheck {
+
+    /** A number for each sample type / topology pair. */
+    template <typename SampleType, typename Topology>
+    constexpr int engineId() {
+        return (int) sizeof(SampleType) * 4
+             + (std::is_same<Topology, BiquadTopology::DirectForm1>::value ? 1
+              : std::is_same<Topology, BiquadTopology::TransposedDirectForm2>::value ? 2 : 3);
+    }
+
+#if defined(_MSC_VER)
+ #define PALDSP_BIQUAD_STRINGIZE_(x) #x
+ #define PALDSP_BIQUAD_STRINGIZE(x) PALDSP_BIQUAD_STRINGIZE_(x)
+ #pragma detect_mismatch("PALDSP_BIQUAD_ENGINE", PALDSP_BIQUAD_STRINGIZE(PALDSP_BIQUAD_SAMPLE_TYPE) " " PALDSP_BIQUAD_STRINGIZE(PALDSP_BIQUAD_TOPOLOGY))
+#else
+    /** The engine of the first translation unit to register, shared by all of them. */
+    inline int selectedEngine = 0;
+
+    inline bool registerEngine(int engine) {
+        if(selectedEngine == 0) selectedEngine = engine;
+        // PALDSP_BIQUAD_SAMPLE_TYPE / PALDSP_BIQUAD_TOPOLOGY differ between
+        // translation units; define them for the whole project instead
+        jassert(selectedEngine == engine);
+        return selectedEngine == engine;
+    }
+
+    // one per translation unit (internal linkage), so each registers its own engine
+    static const bool engineRegistered = registerEngine(engineId<PALDSP_BIQUAD_SAMPLE_TYPE, PALDSP_BIQUAD_TOPOLOGY>());
+#endif
+}
+
+
+#endif /* BiquadCore_h */
@@ -5,12 +5,31 @@
     Created: 25 Mar 2022 5:09:38pm
     Author:  Peter Liley
 
+    Bit depth reduction (quantisation) and desampling (sample and hold).
+
+    process() does both to a block: the quantisation step is worked out
+    when the bit depth is set, and the block is quantised 8 or 4 samples
+    at a time with AVX or SSE2. The sample-and-hold phase and held value
+    carry over from one block to the next, so the output doesn't depend
+    on the block size, and the desampling rate can be fractional (e.g.
+    2.5 holds alternately for 3 and 2 samples).
+
   ==============================================================================
 */
 
 #ifndef BitCrush_h
 #define BitCrush_h
 #include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define PALDSP_BITCRUSH_SSE2 1
+#endif
 
 class BitCrush {
 public:
@@ -18,54 +37,91 @@ public:
         // default rate of 1 (no desampling)
         rate = 1;
         bitDepth = 32;
+        updateQuantisation();
+        reset();
     }
-    
+
     ~BitCrush(){};
-    
+
     /**
-     Sets how many n samples are repeated in the
-     desampling process.
+     Sets how many samples are repeated in the desampling
+     process (1 or more, may be fractional).
      */
-    inline void setDesamplingRate(int rateVal){
-        rate = (rateVal > 0) ? rateVal : rate;
+    inline void setDesamplingRate(float rateVal){
+        rate = (rateVal >= 1) ? rateVal : rate;
     }
-    
+
     /**
      Returns the current desampling rate.
      */
-    inline int getDesamplingRate() {
+    inline float getDesamplingRate() {
         return rate;
     }
-    
+
     /**
      Sets how many quantisation levels will be applied to the signal
      */
     inline void setBitDepth(int bitDepthVal) {
         bitDepth = (bitDepthVal > 0 && bitDepthVal <= 32) ? bitDepthVal : bitDepth;
+        updateQuantisation();
     }
-    
+
     /**
      Gets the current bit depth
      */
     inline int getBitDepth() {
         return bitDepth;
     }
-    
+
+    /**
+     Forgets the held sample, so the next sample desampled is held.
+     */
+    inline void reset() {
+        heldValue = 0;
+        holdPhase = std::numeric_limits<float>::max(); // always due
+    }
+
     /**
-     Takes the buffer and sets every n samples to the same value.
+     Quantises and desamples a block (see quantise and desample).
+     @param data Pointer to the beginning of the buffer.
+     @param bufferLength The length of the current buffer.
+     */
+    inline void process(float* data, int bufferLength) {
+        // quantising is per sample, so it gives the same result before or after the hold
+        quantise(data, bufferLength);
+        desample(data, bufferLength);
+    }
+
+    /**
+     Takes the buffer and holds every nth sample for n samples,
+     carrying on from where the last buffer left off.
      @param data Pointer to the beginning of the buffer.
      @param bufferLength The length of the current buffer.
      */
     inline void desample(float* data, int bufferLength){
-        for(int samp = 0; samp < bufferLength; samp++){
-            // use modulo operator to desample
-            if (rate > 1)
-            {
-                if (samp%rate != 0) data[samp] = data[samp - samp%rate];
+        if(bufferLength <= 0) return;
+        if(rate == 1) {
+            // nothing to hold, just keep the state up to date
+            heldValue = data[bufferLength - 1];
+            holdPhase = rate;
+            return;
+        }
+
+        int samp = 0;
+        while(samp < bufferLength) {
+            if(holdPhase >= rate) {
+                // take a new sample (starting again if the rate has dropped below the phase)
+                holdPhase = (holdPhase - rate < rate) ? holdPhase - rate : 0;
+                heldValue = data[samp];
             }
+            // hold it until the phase next reaches the rate
+            const int run = std::min(bufferLength - samp, (int) ceilf(rate - holdPhase));
+            std::fill_n(data + samp, run, heldValue);
+            holdPhase += (float) run;
+            samp += run;
         }
     }
-    
+
     /**
      Takes the buffer and sets every n samples to the same value,
      accepting a custom n value (instead of using the class field 'rate')
@@ -89,33 +145,92 @@ public:
      This function is pass-by-reference and directly edits the given sample.
      */
     inline void crush(float* sample) {
-        
-        // implementation taken from an online Bitcrusher Demo
-        float totalQLevels = powf(2, bitDepth);
-        *sample = (float) 1/totalQLevels * floor((*sample * totalQLevels) + 0.5);
+        *sample = roundToLevel(*sample);
     }
-    
+
     /**
      Quantizes the audio to the closest signal value between -1 and 1
      according to the value of the bitDepth field.
      @return The quantized sample.
      */
     inline float crush(float sample) {
-        
-        // implementation taken from an online Bitcrusher Demo
-        float totalQLevels = powf(2, bitDepth);
-        float remainder = std::fmodf(sample, 1/totalQLevels);
-        
-        // quantize
-        return sample - remainder;
+        // drop the remainder (towards 0); the level and step are powers of 2, so this is exact
+        return truncf(sample * totalQLevels) * stepSize;
+    }
+
+    /**
+     Quantizes a block of audio (as crush(float*), rounding to the closest level).
+     */
+    inline void quantise(float* data, int bufferLength) {
+        int samp = 0;
+#if defined(__AVX__)
+        const __m256 levels = _mm256_set1_ps(totalQLevels);
+        const __m256 step = _mm256_set1_ps(stepSize);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        for(; samp + 8 <= bufferLength; samp += 8) {
+            const __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(data + samp), levels);
+            const __m256 whole = _mm256_floor_ps(scaled);
+            const __m256 up = _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(scaled, whole), half, _CMP_GE_OQ), one);
+            _mm256_storeu_ps(data + samp, _mm256_mul_ps(_mm256_add_ps(whole, up), step));
+        }
+#elif defined(PALDSP_BITCRUSH_SSE2)
+        const __m128 levels = _mm_set1_ps(totalQLevels);
+        const __m128 step = _mm_set1_ps(stepSize);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        for(; samp + 4 <= bufferLength; samp += 4) {
+            const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(data + samp), levels);
+            const __m128 whole = floorSSE2(scaled);
+            const __m128 up = _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(scaled, whole), half), one);
+            _mm_storeu_ps(data + samp, _mm_mul_ps(_mm_add_ps(whole, up), step));
+        }
+#endif
+        for(; samp < bufferLength; samp++) {
+            data[samp] = roundToLevel(data[samp]);
+        }
     }
-    
 
-    
 private:
-    
-    int rate;
+
+    float rate;
     int bitDepth;
+    float totalQLevels; // 2^bitDepth
+    float stepSize;     // 1 / totalQLevels
+    float holdPhase;    // samples since the held value was taken
+    float heldValue;
+
+    inline void updateQuantisation() {
+        totalQLevels = ldexpf(1.0f, bitDepth);
+        stepSize = ldexpf(1.0f, -bitDepth);
+    }
+
+    /**
+     Rounds a sample to the closest quantisation level (halves round up).
+     Done as floor plus a comparison, rather than floor(x + 0.5), so the
+     vector versions give exactly the same result.
+     */
+    inline float roundToLevel(float sample) {
+        const float scaled = sample * totalQLevels;
+        const float whole = floorf(scaled);
+        return (whole + ((scaled - whole >= 0.5f) ? 1.0f : 0.0f)) * stepSize;
+    }
+
+#if defined(PALDSP_BITCRUSH_SSE2)
+    /**
+     floor for SSE2 (which has no rounding instruction): truncate through
+     int32 and step down for negatives. From 2^23 up every float is a
+     whole number already (and too big to convert), so those pass through,
+     as do NaNs.
+     */
+    static inline __m128 floorSSE2(__m128 x) {
+        const __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+        const __m128 whole = _mm_cmpnlt_ps(magnitude, _mm_set1_ps(8388608.0f));
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        truncated = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+        return _mm_or_ps(_mm_and_ps(whole, x), _mm_andnot_ps(whole, truncated));
+    }
+#endif
 };
 
 
@@ -4,10 +4,39 @@
     CircularBuffer.h
     Created: 8 Apr 2022 1:34:54pm
     Author:  Peter Liley
- 
+
     A circular buffer object based on Pirkle's wire-anded implementation.
     See Pirkle ch.14 for details.
 
+    PALdsp::CircularBuffer<Capacity, Interpolation, FeedbackPolicy> is the
+    one implementation behind all of the library's delay lines:
+    - Capacity: the sample storage, either DelayMemory (right-sized at
+      runtime, optionally from a DelayArena) or FixedDelayMemory<Size>
+      (in-object, compile-time mask).
+    - Interpolation: how modulated reads between samples are made
+      (see DelayInterpolation.h).
+    - FeedbackPolicy: DelayFeedback::None or DelayFeedback::Processed
+      (see DelayFeedback.h).
+
+    CircularBuffer, CircularBufferShort and CircularBufferLong are thin
+    wrappers around it that only keep their original constructors and
+    length/sample rate conventions.
+
+    Besides pushSample/getSample, whole blocks can be moved with
+    pushBlock/readBlock. A pushed block has to fit in the memory the
+    delay (plus modulation range) leaves free, getMaxBlockSize(), so
+    for block processing size the memory with reserveForBlocks() (or
+    a maxLenSamples that includes the block size). For an unmodulated delay the memory at the read
+    (or write) head is also available directly as at most two contiguous
+    spans (the second one starts where the first wraps), and
+    processSpans() runs a function over the read and write heads together
+    without any per-sample wrapping.
+
+    clear() zeroes all of the memory. For a quick reset (e.g. on a preset
+    change) clearReadable() only zeroes what the current length and
+    modulation range can read, and continueClear() can finish the rest a
+    block at a time.
+
   ==============================================================================
 */
 
@@ -16,113 +45,400 @@
 #define CircularBuffer_h
 
 #include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "DelayMemory.h"
+#include "DelayInterpolation.h"
+#include "DelayFeedback.h"
+
+namespace PALdsp {
 
-class CircularBuffer {
+/**
+ A contiguous run of samples inside a delay line.
+ */
+struct DelaySpan {
+    float* data;
+    int size;
+};
+
+/**
+ A region of a delay line, split where it wraps around.
+ second.size is 0 if the region doesn't wrap.
+ */
+struct DelaySpans {
+    DelaySpan first;
+    DelaySpan second;
+};
+
+template <typename Capacity = DelayMemory,
+          typename Interpolation = PALDSP_DELAY_INTERPOLATION,
+          typename FeedbackPolicy = DelayFeedback::None>
+class CircularBuffer : public FeedbackPolicy {
 public:
-    
+
     /**
-     Create a new CircularBuffer data structure
-     with a duration between 0 - 44100 (in samples)
+     Create a buffer with a length of 1 sample.
+     */
+    CircularBuffer() : CircularBuffer (1) {}
+
+    /**
+     Create a new buffer with a given length (in samples) and
+     standard range for modulating the read head (in samples).
+     Memory is sized to the next power of two above the length
+     plus modulation range, and taken from the arena if one is given.
+
+     NB: the range will be -modRange to modRange, being
+     2 * modRange in total range.
      */
-    CircularBuffer(int len){
-        // check that dur is within bounds of buffer memory
-        jassert(len <= buflen && len > 0);
-        std::fill_n(buffer, buflen, 0); // reset the buffer to 0
-        
+    CircularBuffer(int lenSamples, unsigned int modRange = 0, DelayArena* arena = nullptr) {
+        jassert(lenSamples > 0);
+        // room for the taps an interpolator reads behind a fully modulated read head
+        allocate(lenSamples + modRange + Interpolation::before, arena);
+
         // set the read and write head indexes based on
         // specified length
         readHeadIndex = 0;
-        writeHeadIndex = len;
+        writeHeadIndex = lenSamples;
+        this->modRange = modRange;
     }
-    
+
     /**
-     Create a new CircularBuffer data structure
-     with a duration between 0 - 44100 (in samples)
-     and specify a standard range of values for
-     modulating the read head (in samples).
-     
-     NB: the range will be -modulationRange to modulationRange, being
-     2 * modulationRange in total range.
+     As above, with memory for lengths up to maxLenSamples, so the
+     length can later be set (or a wrapper's sample rate raised)
+     beyond the initial length without reallocating.
      */
-    CircularBuffer(unsigned int len, unsigned int modRange){
-        // check that dur is within bounds of buffer memory
-        jassert(len <= buflen && len > 0);
-        // check that the modulation range is within the bounds of the buffer
-        jassert(modRange < buflen / 2);
-        // check that the modulaition won't overflow either end of the buffer
-        jassert(len + modRange < buflen && len - modRange >= 0);
-        
-        std::fill_n(buffer, buflen, 0); // reset the buffer to 0
-        
-        // set the read and write head indexes based on
-        // specified length
+    CircularBuffer(int lenSamples, unsigned int modRange, int maxLenSamples, DelayArena* arena = nullptr) {
+        jassert(lenSamples > 0 && maxLenSamples >= lenSamples);
+        allocate(std::max(lenSamples, maxLenSamples) + modRange + Interpolation::before, arena);
         readHeadIndex = 0;
-        writeHeadIndex = len;
-        // set the offset range
+        writeHeadIndex = lenSamples;
         this->modRange = modRange;
     }
-    
-    
+
+    /**
+     As above, with a feedback policy object to copy in, e.g. a
+     DelayFeedback::Chain holding processors that can't be
+     default-constructed.
+     */
+    CircularBuffer(int lenSamples, unsigned int modRange, FeedbackPolicy feedbackPolicy, DelayArena* arena = nullptr)
+        : FeedbackPolicy (std::move(feedbackPolicy)) {
+        jassert(lenSamples > 0);
+        allocate(lenSamples + modRange + Interpolation::before, arena);
+        readHeadIndex = 0;
+        writeHeadIndex = lenSamples;
+        this->modRange = modRange;
+    }
+
     ~CircularBuffer(){};
-    
+
+    /**
+     Reallocates the delay memory so the length can later be set
+     up to maxLenSamples (plus the modulation range).
+     Clears the buffer and keeps the current length.
+     This allocates, so call it off the audio thread.
+     */
+    void reserve(int maxLenSamples, DelayArena* arena = nullptr) {
+        const int latency = getLatency();
+        allocate(std::max(maxLenSamples, latency) + modRange + Interpolation::before, arena);
+        readHeadIndex = 0;
+        writeHeadIndex = latency;
+    }
+
+    /**
+     As reserve, with room on top for pushBlock to write blocks of
+     up to maxBlockSize samples at lengths up to maxLenSamples.
+     */
+    void reserveForBlocks(int maxLenSamples, int maxBlockSize, DelayArena* arena = nullptr) {
+        reserve(maxLenSamples + maxBlockSize, arena);
+    }
+
+    /**
+     Returns the longest length the memory allows at the
+     current modulation range.
+     */
+    inline int getMaxLengthSamples() {
+        return buffer.getSize() - 1 - modRange - Interpolation::before;
+    }
+
+    /**
+     Returns the number of samples of delay memory.
+     */
+    inline int getCapacity() {
+        return buffer.getSize();
+    }
+
+    /**
+     Returns the largest block pushBlock can take at the current
+     length and modulation range: what the memory holds beyond the
+     samples the read head (and its interpolator) can still reach.
+     */
+    inline int getMaxBlockSize() {
+        return buffer.getSize() - getLatency() - modRange - Interpolation::before;
+    }
+
+    /**
+     Sets all buffer values to 0
+     */
+    inline void clear() {
+        buffer.clear();
+        interpolator = Interpolation();
+        staleSamples = 0;
+    }
+
+    /**
+     Clears only the samples that can still be read at the current
+     length and modulation range, which is all a reset needs to
+     silence the line, so it costs the delay length rather than the
+     whole memory.
+     The rest of the memory keeps its old samples until they are
+     overwritten or continueClear() gets to them; lengthening the
+     delay (setLengthSamples, setModRange) before then can bring
+     them back.
+     */
+    inline void clearReadable() {
+        const int behind = std::min(getLatency() + modRange + Interpolation::before, buffer.getSize());
+        const int ahead = std::min(modRange + Interpolation::taps, buffer.getSize() - behind);
+        clearRange(writeHeadIndex - behind, behind + ahead);
+        interpolator = Interpolation();
+
+        // everything from the write head up to the readable region
+        staleSamples = buffer.getSize() - behind;
+        staleWriteIndex = writeHeadIndex;
+    }
+
+    /**
+     Clears up to maxSamples more of the memory left uncleared by
+     clearReadable(), starting next to the readable region, so that
+     a full clear can be spread over several blocks.
+     Call it once per block; returns true once it is all clear.
+     */
+    inline bool continueClear(int maxSamples) {
+        // anything pushed since has overwritten the stale samples anyway
+        staleSamples = std::max(0, staleSamples - wrap(writeHeadIndex - staleWriteIndex));
+        staleWriteIndex = writeHeadIndex;
+
+        const int n = std::min(maxSamples, staleSamples);
+        clearRange(writeHeadIndex + staleSamples - n, n);
+        staleSamples -= n;
+        return staleSamples == 0;
+    }
+
     /**
      Increments the buffer's write-index and inserts
-     the given value.
+     the given value (plus the fed-back sample, if the
+     buffer has a feedback path).
      */
     inline void pushSample(float sample){
-        //writeHeadIndex &= mask;
+        if constexpr (FeedbackPolicy::enabled) {
+            sample += getFeedback();
+        }
         buffer[writeHeadIndex] = sample;
-        writeHeadIndex++;
-        if (writeHeadIndex >= buflen) writeHeadIndex -= buflen;
+        writeHeadIndex = wrap(writeHeadIndex + 1);
     }
 
     /**
      Returns the next sample and increments the buffer's read-index.
      */
     inline float getSample(){
-        
-        int offSamp0 = floor(readHeadModulation); // get the samples either side
-        int offSamp1 = offSamp0 + 1;          // of the fractional value
+        int offSamp0 = floor(readHeadModulation); // get the sample before
         float offFloat = (float) readHeadModulation - (float) offSamp0; // get the fractional value
-        float samp1 = buffer[wrap(readHeadIndex + offSamp0)];
-        float samp2 = buffer[wrap(readHeadIndex + offSamp1)];
-        
-        readHeadIndex++;
-        //readHeadIndex &= mask; // wrap read head
-        if (readHeadIndex >= buflen) readHeadIndex -= buflen;
-        return lerp(samp1, samp2, offFloat);
+        float samp = readInterpolated(readHeadIndex + offSamp0, offFloat);
+
+        readHeadIndex = wrap(readHeadIndex + 1); // wrap read head
+        return samp;
     }
-    
+
+    /**
+     Reads numSamples from the read head into out and advances it,
+     as that many calls to getSample would (with the modulation offset
+     held for the block). Unmodulated reads are just copies of the
+     two spans at the read head.
+     numSamples can be at most the current delay, so that no
+     sample is read before it would have been pushed.
+     */
+    inline void readBlock(float* out, int numSamples) {
+        jassert(numSamples <= getLatency());
+        if(readHeadModulation == 0) {
+            const DelaySpans spans = getReadSpans(numSamples);
+            memcpy(out, spans.first.data, spans.first.size * sizeof(float));
+            memcpy(out + spans.first.size, spans.second.data, spans.second.size * sizeof(float));
+            advanceRead(numSamples);
+        }
+        else {
+            for(int i = 0; i < numSamples; i++) {
+                out[i] = getSample();
+            }
+        }
+    }
+
+    /**
+     Pushes numSamples at the write head and advances it.
+     With a feedback path, sample i is fed back from read head + i,
+     i.e. this matches pushSample/getSample pairs in that order
+     (push first). Without one it is just copies into the two spans
+     at the write head.
+     numSamples can be at most getMaxBlockSize(): any more would
+     overwrite samples that haven't been read yet (and wrap the
+     delay round to a short one).
+     */
+    inline void pushBlock(const float* in, int numSamples) {
+        jassert(numSamples <= getMaxBlockSize());
+        if constexpr (FeedbackPolicy::enabled) {
+            // run the feedback processing a chunk at a time; a chunk no longer
+            // than the delay only feeds back samples written before it
+            float fedBack[feedbackChunkSize];
+            const int chunkSize = std::min(feedbackChunkSize, getLatency());
+            for(int start = 0; start < numSamples; start += chunkSize) {
+                const int n = std::min(chunkSize, numSamples - start);
+                for(int i = 0; i < n; i++) {
+                    fedBack[i] = buffer[wrap(readHeadIndex + start + i)];
+                }
+                this->applyFeedbackBlock(fedBack, n);
+                for(int i = 0; i < n; i++) {
+                    buffer[wrap(writeHeadIndex + start + i)] = in[start + i] + fedBack[i];
+                }
+            }
+            advanceWrite(numSamples);
+        }
+        else {
+            const DelaySpans spans = getWriteSpans(numSamples);
+            memcpy(spans.first.data, in, spans.first.size * sizeof(float));
+            memcpy(spans.second.data, in + spans.first.size, spans.second.size * sizeof(float));
+            advanceWrite(numSamples);
+        }
+    }
+
+    /**
+     Returns the next numSamples at the read head (ignoring any
+     modulation) as at most two contiguous spans.
+     Call advanceRead once they have been used.
+     */
+    inline DelaySpans getReadSpans(int numSamples) {
+        return getSpans(readHeadIndex, numSamples);
+    }
+
+    /**
+     Returns the next numSamples at the write head as at most two
+     contiguous spans to be written directly.
+     Call advanceWrite once they have been filled.
+     */
+    inline DelaySpans getWriteSpans(int numSamples) {
+        return getSpans(writeHeadIndex, numSamples);
+    }
+
+    inline void advanceRead(int numSamples) {
+        readHeadIndex = wrap(readHeadIndex + numSamples);
+    }
+
+    inline void advanceWrite(int numSamples) {
+        writeHeadIndex = wrap(writeHeadIndex + numSamples);
+    }
+
+    /**
+     Runs function(const float* read, float* write, int offset, int n)
+     over numSamples at the (unmodulated) read and write heads, split
+     into the few runs where neither head wraps, then advances both.
+     offset is the position of the run within the block.
+     This is the zero-copy equivalent of getSample/pushSample pairs:
+     as long as the function handles each sample before the next, the
+     block can be longer than the delay. The buffer's own feedback path
+     is not applied.
+     */
+    template <typename Function>
+    inline void processSpans(int numSamples, Function&& function) {
+        float* data = buffer.getData();
+        const int size = buffer.getSize();
+        int done = 0;
+        while(done < numSamples) {
+            // split at the physical end even with mirrored memory: a run that
+            // reads through the mirror would be at a different address from the
+            // same samples being written, so the function (or the compiler's
+            // overlap check when it vectorises) couldn't see that they alias
+            const int n = std::min(numSamples - done, std::min(size - readHeadIndex, size - writeHeadIndex));
+            function((const float*) data + readHeadIndex, data + writeHeadIndex, done, n);
+            advanceRead(n);
+            advanceWrite(n);
+            done += n;
+        }
+    }
+
+    /**
+     The modulated counterpart of processSpans: for each of numSamples
+     samples, reads at the read head plus a modulation offset that
+     ramps linearly from its current value to targetModulation (reached
+     on the last sample), then pushes function(delayed, i), where i is
+     the position in the block. The offset is left at targetModulation.
+     Used to run control-rate modulation (a new target every few
+     samples) without setting the offset per sample. The buffer's own
+     feedback path is not applied.
+     */
+    template <typename Function>
+    inline void processModulated(int numSamples, float targetModulation, Function&& function) {
+        const float step = (targetModulation - readHeadModulation) / (float) numSamples;
+        for(int i = 0; i < numSamples; i++) {
+            const float offset = targetModulation - step * (float) (numSamples - 1 - i);
+            const int offSamp0 = (int) floorf(offset);
+            const float delayed = readInterpolated(readHeadIndex + offSamp0, offset - (float) offSamp0);
+            readHeadIndex = wrap(readHeadIndex + 1);
+
+            buffer[writeHeadIndex] = function(delayed, i);
+            writeHeadIndex = wrap(writeHeadIndex + 1);
+        }
+        readHeadModulation = targetModulation;
+    }
+
+    /**
+     Get a custom index from the buffer.
+     index 0 means no delay
+     index 100 = 100 samples of delay, etc.
+     */
+    inline float tap(int index) {
+        jassert(index < getLatency());
+        return buffer[wrap(writeHeadIndex - index)];
+    }
+
+    /**
+     Returns a fed-back sample from the read head
+     with any given effects applied.
+     */
+    inline float getFeedback() {
+        static_assert(FeedbackPolicy::enabled, "this buffer has no feedback path");
+        return this->applyFeedback(buffer[readHeadIndex]);
+    }
+
     /**
      Returns the distance between the front and
      back indexes of the buffer
      */
     inline int getLatency() {
         if(writeHeadIndex > readHeadIndex) return writeHeadIndex - readHeadIndex;
-        else return (writeHeadIndex + buflen) - readHeadIndex;
+        else return (writeHeadIndex + buffer.getSize()) - readHeadIndex;
     }
-    
+
     inline float getMaxLatency() {
-        if(writeHeadIndex > readHeadIndex) return writeHeadIndex - readHeadIndex + modRange;
-        else return (writeHeadIndex + buflen) - readHeadIndex + modRange;
+        return getLatency() + modRange;
     }
-    
+
     /**
      Sets the standard range of samples ahead of  / behind the
      read position in the buffer that the modulation offset may be.
      */
-    inline void setModRange(float offsetRangeIn){
+    inline void setModRange(float newModRange){
         // CHECKUP
-        modRange = (offsetRangeIn > getLatency() || offsetRangeIn < 0) ? 0 : offsetRangeIn;
+        modRange = (newModRange > getLatency() || newModRange < 0) ? 0 : newModRange;
     }
-    
+
     /**
-     Sets the length of the delay line (in samples)
+     Sets the length of the delay line in samples.
      */
-    inline void setReadHeadDelay(int delay) {
-        readHeadIndex = wrap(writeHeadIndex - delay);
+    inline void setLengthSamples(int length) {
+        // past the memory this would wrap to a short delay, so hold it at the longest instead
+        // (construct with a maximum length, or call reserve, to allow longer)
+        jassert(length > 0 && length <= getMaxLengthSamples());
+        length = std::max(1, std::min(length, getMaxLengthSamples()));
+        readHeadIndex = wrap(writeHeadIndex - length);
     }
-    
+
     /**
      Sets the number of samples the read head is offset from its
      default delay length. Used to modulate the read head
@@ -132,46 +448,146 @@ public:
     inline void setReadHeadModulation(float offset){
         readHeadModulation = offset;
     }
-    
+
     /**
      Uses a given input between -1 and 1 to map the
      read head offset to somewhere in its set range.
      For use in automatic read head offsetting by an LFO.
+     e.g. if modulation range is 20 samples, an offset of
+     0.5 will offset the read head by +10 samples.
      */
     inline void mapReadHeadMod(float lfoOffset){
-        //jassert(lfoOffset >=-1.0f && lfoOffset <= 1.0f);
+        readHeadModulation = mapModulation(lfoOffset);
+    }
+
+    /**
+     As above, reading the input from one lane of a shared
+     modulation source such as an LFOBank.
+     */
+    template <typename ModulationSource>
+    inline void mapReadHeadMod(const ModulationSource& source, int lane){
+        mapReadHeadMod(source.getValue(lane));
+    }
+
+    /**
+     Returns the read head offset mapReadHeadMod would set for
+     a given input between -1 and 1, without setting it.
+     */
+    inline float mapModulation(float lfoOffset){
         if(lfoOffset < -1) lfoOffset = -1;
         if(lfoOffset > 1) lfoOffset = 1;
-        readHeadModulation = modRange * lfoOffset;
+        return modRange * lfoOffset;
+    }
+
+    inline float getReadHeadModulation() {
+        return readHeadModulation;
     }
-    
-private:
-    unsigned const int buflen = 65536; // 2^16 (the smallest power of 2 above 44.1k)
-    float buffer[65536];
-    int mask = 65535; // for Pirkle's wire-and buffer wrapping (pg.395)
+
+protected:
+    static constexpr int feedbackChunkSize = 64;
+
+    Capacity buffer;
+    Interpolation interpolator; // only has state for e.g. Thiran
     int writeHeadIndex;
     int readHeadIndex;
-    float readHeadModulation;
+    float readHeadModulation = 0;
     int modRange = 0;
-    int modCentreIndex = 0; // the 'centre' of the modulation (as an offset from the write head)
-    
+    int staleSamples = 0; // not yet cleared since clearReadable, from the write head on
+    int staleWriteIndex = 0; // the write head when staleSamples was last updated
+
     /**
-     Simple linear interpolation
+     (Re)allocates cleared delay memory for up to maxDelay samples.
      */
-    float lerp(float a, float b, float t)
-    {
-        return a + t * (b - a);
+    void allocate(int maxDelay, DelayArena* arena) {
+        buffer.allocate(maxDelay, arena);
+        staleSamples = 0;
     }
-    
+
+    /**
+     Sets numSamples from start (wrapped) to 0.
+     */
+    inline void clearRange(int start, int numSamples) {
+        start = wrap(start);
+        const int firstSize = std::min(numSamples, buffer.getSize() - start);
+        std::fill_n(buffer.getData() + start, firstSize, 0.0f);
+        std::fill_n(buffer.getData(), numSamples - firstSize, 0.0f);
+    }
+
+    /**
+     Reads between samples at index + frac with the interpolation policy.
+     Mirrored memory is read in place; otherwise the taps are gathered
+     with wrapping first.
+     */
+    inline float readInterpolated(int index, float frac) {
+        const int start = index - Interpolation::before;
+        if(buffer.isMirrored()) {
+            return interpolator.interpolate(buffer.getData() + wrap(start), frac);
+        }
+        float x[Interpolation::taps];
+        for(int k = 0; k < Interpolation::taps; k++) {
+            x[k] = buffer[wrap(start + k)];
+        }
+        return interpolator.interpolate(x, frac);
+    }
+
+    /**
+     Splits numSamples from start into the part before the end
+     of the memory and the part wrapped round to the beginning
+     (always one part with mirrored memory).
+     */
+    inline DelaySpans getSpans(int start, int numSamples) {
+        const int contiguous = buffer.isMirrored() ? 2 * buffer.getSize() : buffer.getSize();
+        const int firstSize = std::min(numSamples, contiguous - start);
+        return { { buffer.getData() + start, firstSize },
+                 { buffer.getData(), numSamples - firstSize } };
+    }
+
     /**
      Takes a sample index value and returns an appropriately
-     wrapped value if necessary, or the original value if not
+     wrapped value (Pirkle's wire-and wrapping, pg.395)
      */
-    int wrap(int value) {
-//        if (value >= buflen) return value - buflen;
-//        else if (value < 0) return buflen + value;
-//        else return value;
-        return value &= mask;
+    inline int wrap(int value) {
+        return value & buffer.getMask();
+    }
+};
+
+}
+
+/**
+ A plain (no feedback) delay line with its length in samples.
+ */
+class CircularBuffer : public PALdsp::CircularBuffer<> {
+public:
+
+    /**
+     Create a new CircularBuffer data structure
+     with a given duration (in samples).
+     Memory is sized to the next power of two above len,
+     and taken from the arena if one is given.
+     */
+    CircularBuffer(int len, DelayArena* arena = nullptr)
+        : PALdsp::CircularBuffer<> (len, 0, arena) {}
+
+    /**
+     Create a new CircularBuffer data structure
+     with a given duration (in samples)
+     and specify a standard range of values for
+     modulating the read head (in samples).
+
+     NB: the range will be -modulationRange to modulationRange, being
+     2 * modulationRange in total range.
+     */
+    CircularBuffer(unsigned int len, unsigned int modRange, DelayArena* arena = nullptr)
+        : PALdsp::CircularBuffer<> ((int) len, modRange, arena) {
+        // check that the modulaition won't overflow either end of the buffer
+        jassert(len >= modRange);
+    }
+
+    /**
+     Sets the length of the delay line (in samples)
+     */
+    inline void setReadHeadDelay(int delay) {
+        setLengthSamples(delay);
     }
 };
 
@@ -4,10 +4,14 @@
     CircularBuffer.h
     Created: 8 Apr 2022 1:34:54pm
     Author:  Peter Liley
- 
+
     A circular buffer object based on Pirkle's wire-anded implementation.
     See Pirkle ch.14 for details.
 
+    A feedback delay line with its length set in seconds.
+    Changing the sample rate keeps the length in seconds.
+    See PALdsp::CircularBuffer for the implementation.
+
   ==============================================================================
 */
 
@@ -15,254 +19,117 @@
 #ifndef CircularBufferLong_h
 #define CircularBufferLong_h
 
-#include <math.h>
-#include <vector>
+#include "CircularBuffer.h"
 
-class CircularBufferLong {
+class CircularBufferLong : public PALdsp::CircularBuffer<DelayMemory,
+                                                        PALDSP_DELAY_INTERPOLATION,
+                                                        DelayFeedback::Processed> {
 public:
-    
+    typedef PALdsp::CircularBuffer<DelayMemory, PALDSP_DELAY_INTERPOLATION, DelayFeedback::Processed> Base;
+    using Base::reserve;
+
     /**
      Create a new CircularBuffer data structure
-     with a duration between 0 - 5 seconds
+     with a duration in seconds.
+     Memory is sized for defaultMaxLength samples (the 2^18-sample
+     buffer this class has always had, about 5.9 seconds at 44.1kHz),
+     or the length if longer, and taken from the arena if one is given.
      */
-    CircularBufferLong(float len){
-        // check that dur is within bounds of buffer memory
-        jassert(len * sampleRate <= buflen && len > 0);
-        
-        std::fill_n(buffer, buflen, 0); // reset the buffer to 0
-        
-        durationSecs = len;
-        
-        // set the read and write head indexes based on
-        // specified length
-        readHeadIndex = 0;
-        writeHeadIndex = len * sampleRate;
-    }
-    
+    CircularBufferLong(float len, DelayArena* arena = nullptr)
+        : CircularBufferLong (len, 0.0f, 0u, defaultMaxLength, arena) {}
+
     /**
      Create a new CircularBuffer data structure
-     with a duration between 0 - 5 seconds, and
+     with a duration in seconds, and
      a given feedback amount (from 0 - 1).
      */
-    CircularBufferLong(float len, float feedback){
-        // check that dur is within bounds of buffer memory
-        jassert(len * sampleRate <= buflen && len > 0);
-        
-        std::fill_n(buffer, buflen, 0); // reset the buffer to 0
-        
-        durationSecs = len;
-        this->feedback = feedback;
-        
-        // set the read and write head indexes based on
-        // specified length
-        readHeadIndex = 0;
-        writeHeadIndex = len * sampleRate;
-    }
-    
+    CircularBufferLong(float len, float feedback, DelayArena* arena = nullptr)
+        : CircularBufferLong (len, feedback, 0u, defaultMaxLength, arena) {}
+
     /**
      Create a new CircularBuffer data structure
-     with a duration between 0 - 5 seconds
+     with a duration in seconds
      and specify a standard range of values for
      modulating the read head (in samples).
-     
+
      NB: the range will be -modulationRange to modulationRange, being
      2x modulationRange in total range.
      */
-    CircularBufferLong(float len, unsigned int modRange){
-        // check that dur is within bounds of buffer memory
-        jassert(len * sampleRate <= buflen && len > 0);
-        // check that the modulation range is within the bounds of the buffer
-        jassert(modRange < buflen / 2);
+    CircularBufferLong(float len, unsigned int modRange, DelayArena* arena = nullptr)
+        : CircularBufferLong (len, 0.0f, modRange, defaultMaxLength, arena) {}
 
-        std::fill_n(buffer, buflen, 0); // reset the buffer to 0
-        
-        durationSecs = len;
-        
-        // set the read and write head indexes based on
-        // specified length
-        readHeadIndex = 0;
-        writeHeadIndex = len * sampleRate;
-        // set the offset range
-        this->modRange = modRange;
-    }
-    
-    
-    ~CircularBufferLong(){};
-    
     /**
-     Sets all buffer values to 0
+     Create a new CircularBuffer data structure with a duration in
+     seconds, and memory for durations up to maxLen seconds at sample
+     rates up to maxSampleRate (e.g. less than the default, to save
+     memory, or more, for long delays at high rates).
+     Feedback and modulation range are optional.
      */
-    inline void clear() {
-        std::fill_n(buffer, buflen, 0);
-    }
-    
-    /**
-     Increments the buffer's write-index and inserts
-     the given value.
-     */
-    inline void pushSample(float sample){
-        //writeHeadIndex &= mask;
-        buffer[writeHeadIndex] = sample + getFeedback();
-        writeHeadIndex++;
-        writeHeadIndex &= mask;
-        //if (writeHeadIndex >= buflen) writeHeadIndex -= buflen;
-    }
+    CircularBufferLong(float len, float maxLen, int maxSampleRate, float feedback = 0,
+                       unsigned int modRange = 0, DelayArena* arena = nullptr)
+        : CircularBufferLong (len, feedback, modRange, (int) ceil(maxLen * maxSampleRate), arena) {}
+
+    ~CircularBufferLong(){};
 
     /**
-     Returns the next sample and increments the buffer's read-index.
-     */
-    inline float getSample(){
-        
-        int offSamp0 = floor(readHeadModulation); // get the samples either side
-        int offSamp1 = offSamp0 + 1;          // of the fractional value
-        float offFloat = (float) readHeadModulation - (float) offSamp0; // get the fractional value
-        float samp1 = buffer[wrap(readHeadIndex + offSamp0)];
-        float samp2 = buffer[wrap(readHeadIndex + offSamp1)];
-        
-        readHeadIndex++;
-        readHeadIndex &= mask; // wrap read head
-        //if (readHeadIndex >= buflen) readHeadIndex -= buflen;
-        return lerp(samp1, samp2, offFloat);
-    }
-    
-    /**
-     Returns a fed-back sample from the read head
-     with any given effects applied.
-     */
-    float getFeedback() {
-        float samp = buffer[readHeadIndex];
-        // enact all feedback processing
-        for(std::function<float(float)> function : feedbackFunctions) {
-            samp = function(samp);
-        }
-        return samp * feedback;
-    }
-    
-    /**
-     Adds a function that will be applied to each sample that passes through the 'feedback' loop.
-     */
-    void addFeedbackProcessor(std::function<float(float)> function) {
-        feedbackFunctions.push_back(function);
-    }
-    
-    int getNumFeedbackProcessors() {
-        return (int) feedbackFunctions.size();
-    }
-    
-    
-    /**
-     Returns the distance between the front and
-     back indexes of the buffer
-     */
-    inline int getLatency() {
-        if(writeHeadIndex > readHeadIndex) return writeHeadIndex - readHeadIndex;
-        else return (writeHeadIndex + buflen) - readHeadIndex;
-    }
-    
-    inline float getMaxLatency() {
-        if(writeHeadIndex > readHeadIndex) return writeHeadIndex - readHeadIndex + modRange;
-        else return (writeHeadIndex + buflen) - readHeadIndex + modRange;
-    }
-    
-    /**
-     Sets the standard range of samples ahead of  / behind the
-     read position in the buffer that the modulation offset may be.
+     Reallocates the delay memory so the delay can later be set up to
+     maxLen seconds (plus the modulation range) at up to maxSampleRate,
+     e.g. before calling setSampleRate with a higher rate.
+     Clears the buffer and keeps the current delay.
+     This allocates, so call it off the audio thread.
      */
-    inline void setModRange(float newModRange){
-        // CHECKUP
-        modRange = (newModRange > getLatency() || newModRange < 0) ? 0 : newModRange;
+    void reserve(float maxLen, int maxSampleRate, DelayArena* arena = nullptr) {
+        Base::reserve((int) (maxLen * maxSampleRate), arena);
     }
-    
+
     /**
      Sets the length of the delay line
      */
     inline void setReadHeadDelay(float dur) {
-        jassert(dur * sampleRate < buflen);
-        readHeadIndex = wrap(writeHeadIndex - (int) (dur * sampleRate));
+        const int length = (int) (dur * sampleRate);
+        setLengthSamples(length);
+        if(getLatency() != length) {
+            dur = getLatency() / (float) sampleRate; // held at the longest the memory allows
+        }
         durationSecs = dur;
     }
-    
-    /**
-     Sets the number of samples the read head is offset from its
-     default delay length. Used to modulate the read head
-     for chorusing effects, etc.
-     Values can be negative.
-     */
-    inline void setReadHeadModulation(float offset){
-        readHeadModulation = offset;
-    }
-    
-    /**
-     Uses a given input between -1 and 1 to map the
-     read head offset to somewhere in its set range.
-     For use in automatic read head offsetting by an LFO.
-     */
-    inline void mapReadHeadMod(float lfoOffset){
-        jassert(lfoOffset >=-1.0f && lfoOffset <= 1.0f);
-        readHeadModulation = modRange * lfoOffset;
-    }
-    
-    /**
-     Set the amount of feedback in the buffer.
-     (value from 0 - 1)
-     */
-    inline void setFeedback(float newValue) {
-        jassert(newValue <= 1 && newValue >= 0);
-        feedback = newValue;
-    }
-    
+
     /**
      Set the current sample rate
      */
     inline void setSampleRate(int newRate) {
         sampleRate = newRate;
-        
-        // check that the new sample rate won't exceed the buffer
-        if(durationSecs * sampleRate >= buflen) {
-            durationSecs = 0;
+
+        // check that the new sample rate won't exceed the buffer;
+        // if it does, hold the delay at the longest the memory allows
+        // (construct with a higher maxSampleRate, or call reserve first)
+        if(durationSecs * sampleRate > getMaxLengthSamples()) {
+            jassertfalse;
+            durationSecs = getMaxLengthSamples() / (float) sampleRate;
         }
-        
+
         // set the read and write head indexes based on
         // specified length
         readHeadIndex = 0;
         writeHeadIndex = durationSecs * sampleRate;
     }
-    
-private:
-    unsigned const int buflen = 262144; // 2^18
-    float buffer[262144];
-    int mask = 262143; // for Pirkle's wire-and buffer wrapping (pg.395)
-    int sampleRate = 44100;
-    float durationSecs;
-    int writeHeadIndex;
-    int readHeadIndex;
-    float feedback = 0;
-    float readHeadModulation;
-    int modRange = 0;
-    int modCentreIndex = 0; // the 'centre' of the modulation (as an offset from the write head)
-    
-    // vector of (pointers to) functions that will be applied to feedback samples
-    // (a fancy, and possibly unneccessary approach to feedback processing)
-    std::vector<std::function<float(float)>> feedbackFunctions;
-    
-    /**
-     Simple linear interpolation
-     */
-    float lerp(float a, float b, float t)
-    {
-        return a + t * (b - a);
-    }
-    
+
     /**
-     Takes a sample index value and returns an appropriately
-     wrapped value if necessary, or the original value if not
+     The default maximum length in samples.
      */
-    int wrap(int value) {
-//        if (value >= buflen) return value - buflen;
-//        else if (value < 0) return buflen + value;
-//        else return value;
-        
-        return value &= mask;
+    static constexpr int defaultMaxLength = 262143;
+
+private:
+    static constexpr int defaultSampleRate = 44100;
+    int sampleRate = defaultSampleRate;
+    float durationSecs;
+
+    CircularBufferLong(float len, float feedback, unsigned int modRange, int maxLenSamples, DelayArena* arena)
+        : Base ((int) (len * defaultSampleRate), modRange,
+                std::max(maxLenSamples, (int) (len * defaultSampleRate)), arena) {
+        jassert(len > 0);
+        durationSecs = len;
+        this->feedback = feedback;
     }
 };
 
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    Convolver.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Convolution reverb/FIR processor for long impulse responses.
+    By default it is a single UniformConvolver (latency = blockSize).
+
+    Given a smaller headBlockSize it becomes a two-stage non-uniform
+    convolver: the start of the IR runs through small partitions (low
+    latency), and the rest through large partitions (cheap per sample).
+    With head size B1 and tail size B2, the head covers the first
+    B2 - B1 IR samples. The tail's own B2 latency then lines it up exactly
+    behind the head, so the overall latency is B1.
+
+    NB: the tail does its FFT work in one go every B2 samples, so the
+    per-callback cost is uneven; keep B2 a small multiple of the host
+    block size if that matters.
+
+  ==============================================================================
+*/
+
+#ifndef Convolver_h
+#define Convolver_h
+
+#include <memory>
+#include <algorithm>
+#include "UniformConvolver.h"
+
+class Convolver {
+public:
+
+    /**
+     Creates a convolver for the given impulse response.
+     Allocates and transforms the IR, so construct it off the audio thread.
+     @param impulseResponse The IR samples.
+     @param irLength The number of IR samples.
+     @param blockSize Partition size for the IR (power of two).
+     @param headBlockSize Optional smaller partition size for the start of
+                          the IR (power of two, 0 = uniform partitioning).
+     */
+    Convolver(const float* impulseResponse, int irLength, int blockSize = 1024, int headBlockSize = 0) {
+        jassert(irLength > 0);
+        jassert(headBlockSize == 0 || headBlockSize < blockSize);
+
+        const int headLength = blockSize - headBlockSize;
+
+        if(headBlockSize > 0 && headBlockSize < blockSize && irLength > headLength) {
+            head.reset(new UniformConvolver(impulseResponse, headLength, headBlockSize));
+            tail.reset(new UniformConvolver(impulseResponse + headLength, irLength - headLength, blockSize));
+            latency = headBlockSize;
+        }
+        else {
+            const int size = (headBlockSize > 0) ? headBlockSize : blockSize;
+            head.reset(new UniformConvolver(impulseResponse, irLength, size));
+            latency = size;
+        }
+    }
+
+    ~Convolver(){};
+
+    /**
+     Convolves a block of samples. in and out may be the same buffer.
+     */
+    void processBlock(const float* in, float* out, int numSamples) {
+        if(tail == nullptr) {
+            head->processBlock(in, out, numSamples);
+            return;
+        }
+
+        for(int start = 0; start < numSamples; start += scratchSize) {
+            const int n = std::min(scratchSize, numSamples - start);
+            // the tail reads the input before the head may overwrite it in place
+            tail->processBlock(in + start, scratch, n);
+            head->processBlock(in + start, out + start, n);
+            for(int i = 0; i < n; i++) {
+                out[start + i] += scratch[i];
+            }
+        }
+    }
+
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+
+    /**
+     Clears all audio history (the IR is kept).
+     */
+    void reset() {
+        head->reset();
+        if(tail != nullptr) tail->reset();
+    }
+
+    /** Latency in samples. */
+    inline int getLatency() {
+        return latency;
+    }
+
+private:
+    static constexpr int scratchSize = 256;
+
+    std::unique_ptr<UniformConvolver> head;
+    std::unique_ptr<UniformConvolver> tail;
+    int latency;
+    float scratch[scratchSize];
+};
+
+
+#endif /* Convolver_h */
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    DelayArena.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A simple bump allocator for delay-line memory. A reverb or other
+    network of short delays can take all of its buffers from one arena,
+    so they sit next to each other in memory (and in cache) instead of
+    each line owning its own worst-case block.
+
+    e.g. for a set of allpasses:
+
+        size_t size = 0;
+        for(int len : lengths) size += DelayArena::getRequiredSize(len);
+        DelayArena arena (size);
+        for(int len : lengths) allpasses.emplace_back(len, 0.5f, 0.5f, &arena);
+
+    The arena must outlive every buffer allocated from it. Memory is only
+    given back all at once, with reset().
+
+  ==============================================================================
+*/
+
+#ifndef DelayArena_h
+#define DelayArena_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class DelayArena {
+public:
+
+    /**
+     Creates an arena that owns numFloats floats of storage.
+     */
+    DelayArena(size_t numFloats) {
+        owned.resize(numFloats + alignment);
+        base = align(owned.data());
+        size = numFloats;
+    }
+
+    /**
+     Creates an arena over caller-owned memory, e.g. a pool shared with
+     other processors. The memory is not freed by the arena.
+     */
+    DelayArena(float* memory, size_t numFloats) {
+        base = align(memory);
+        const size_t skipped = (size_t) (base - memory);
+        size = (numFloats > skipped) ? numFloats - skipped : 0;
+    }
+
+    ~DelayArena(){};
+
+    DelayArena(const DelayArena&) = delete;
+    DelayArena& operator=(const DelayArena&) = delete;
+
+    /**
+     Returns a cache-line aligned block of numFloats floats,
+     or nullptr if the arena is exhausted.
+     The block's contents are not cleared.
+     */
+    float* allocate(int numFloats) {
+        const size_t n = roundUp((size_t) numFloats);
+        if(used + n > size) {
+            jassertfalse; // arena too small for the requested delays
+            return nullptr;
+        }
+        float* block = base + used;
+        used += n;
+        return block;
+    }
+
+    /**
+     Gives back all the memory at once. Any buffers still using
+     blocks from this arena must be reallocated or destroyed first.
+     */
+    inline void reset() {
+        used = 0;
+    }
+
+    inline size_t getSize() {
+        return size;
+    }
+
+    inline size_t getNumUsed() {
+        return used;
+    }
+
+    /**
+     Returns the power-of-two capacity used for a delay of up to
+     maxDelaySamples (the next power of two above it).
+     */
+    static int getDelayCapacity(int maxDelaySamples) {
+        int capacity = 1;
+        while(capacity <= maxDelaySamples) capacity <<= 1;
+        return capacity;
+    }
+
+    /**
+     Returns the number of arena floats a delay of up to
+     maxDelaySamples will take (including alignment).
+     */
+    static size_t getRequiredSize(int maxDelaySamples) {
+        return roundUp((size_t) getDelayCapacity(maxDelaySamples));
+    }
+
+private:
+    static constexpr size_t alignment = 16; // in floats (64 bytes, one cache line)
+
+    std::vector<float> owned;
+    float* base = nullptr;
+    size_t size = 0;
+    size_t used = 0;
+
+    static size_t roundUp(size_t numFloats) {
+        return (numFloats + alignment - 1) & ~(alignment - 1);
+    }
+
+    static float* align(float* memory) {
+        const uintptr_t bytes = alignment * sizeof(float);
+        const uintptr_t address = (uintptr_t) memory;
+        return (float*) ((address + bytes - 1) & ~(bytes - 1));
+    }
+};
+
+
+#endif /* DelayArena_h */
@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    DelayFeedback.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Feedback policies for PALdsp::CircularBuffer. The buffer inherits
+    from its policy, so the feedback controls only exist on buffers that
+    have a feedback path.
+
+    - None: no feedback path.
+    - Processed: feedback gain plus std::functions added at runtime with
+      addFeedbackProcessor (set up before processing starts).
+    - Chain<Processors...>: the same, but the processors are fixed at
+      compile time and stored inline, so the whole chain can be inlined
+      and never allocates. Processors need processSample(float) or
+      operator()(float); if they have processBlock(float*, int) it is
+      used for whole blocks (pushBlock).
+
+        auto chain = DelayFeedback::makeChain(LPF(LPF::FIRSTORDER, 3000, 0.7f),
+                                              [](float x) { return tanhf(x); });
+        PALdsp::CircularBuffer<DelayMemory, DelayInterpolation::Linear, decltype(chain)>
+            delay (lengthSamples, 0, chain);
+        delay.setFeedback(0.6f);
+
+  ==============================================================================
+*/
+
+#ifndef DelayFeedback_h
+#define DelayFeedback_h
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "Denormals.h"
+
+namespace DelayFeedback {
+
+    /**
+     No feedback path: a plain delay line.
+     */
+    struct None {
+        static constexpr bool enabled = false;
+    };
+
+    /**
+     Feeds the sample at the read head back into the write head,
+     scaled by a feedback gain and passed through any number of
+     processing functions.
+     */
+    class Processed {
+    public:
+        static constexpr bool enabled = true;
+
+        /**
+         Set the amount of feedback in the buffer.
+         (value from 0 - 1)
+         */
+        inline void setFeedback(float newValue) {
+            jassert(newValue <= 1 && newValue >= 0);
+            feedback = newValue;
+        }
+
+        inline float getFeedbackGain() {
+            return feedback;
+        }
+
+        /**
+         Adds a function that will be applied to each sample that passes through the 'feedback' loop.
+         This allocates, so add all processors before processing starts.
+         */
+        void addFeedbackProcessor(std::function<float(float)> function) {
+            jassert(! processingStarted); // the audio thread may be using the list
+            feedbackFunctions.push_back(std::move(function));
+        }
+
+        int getNumFeedbackProcessors() {
+            return (int) feedbackFunctions.size();
+        }
+
+    protected:
+        float feedback = 0;
+        bool processingStarted = false;
+
+        // vector of (pointers to) functions that will be applied to feedback samples
+        // (a fancy, and possibly unneccessary approach to feedback processing)
+        std::vector<std::function<float(float)>> feedbackFunctions;
+
+        /**
+         Applies all feedback processing and the feedback gain to a sample.
+         */
+        inline float applyFeedback(float samp) {
+            processingStarted = true;
+            for(const auto& function : feedbackFunctions) {
+                samp = function(samp);
+            }
+            return flushDenormal(samp * feedback);
+        }
+
+        /**
+         Applies all feedback processing and the feedback gain to a
+         block, one function at a time.
+         */
+        inline void applyFeedbackBlock(float* data, int numSamples) {
+            processingStarted = true;
+            for(const auto& function : feedbackFunctions) {
+                for(int i = 0; i < numSamples; i++) {
+                    data[i] = function(data[i]);
+                }
+            }
+            const float gain = feedback;
+            for(int i = 0; i < numSamples; i++) {
+                data[i] = flushDenormal(data[i] * gain);
+            }
+        }
+    };
+
+    template <typename P, typename = void>
+    struct HasProcessSample : std::false_type {};
+
+    template <typename P>
+    struct HasProcessSample<P, std::void_t<decltype(std::declval<P&>().processSample(0.0f))>> : std::true_type {};
+
+    template <typename P, typename = void>
+    struct HasProcessBlock : std::false_type {};
+
+    template <typename P>
+    struct HasProcessBlock<P, std::void_t<decltype(std::declval<P&>().processBlock((float*) nullptr, 0))>> : std::true_type {};
+
+    /**
+     A feedback gain plus a compile-time chain of processors,
+     applied in order and stored inline.
+     */
+    template <typename... Processors>
+    class Chain {
+    public:
+        static_assert(sizeof...(Processors) > 0, "an empty chain is just a gain: use Processed");
+        static constexpr bool enabled = true;
+
+        Chain() = default;
+
+        Chain(Processors... processorsIn) : processors (std::move(processorsIn)...) {}
+
+        /**
+         Set the amount of feedback in the buffer.
+         (value from 0 - 1)
+         */
+        inline void setFeedback(float newValue) {
+            jassert(newValue <= 1 && newValue >= 0);
+            feedback = newValue;
+        }
+
+        inline float getFeedbackGain() {
+            return feedback;
+        }
+
+        /**
+         Returns processor Index of the chain, e.g. to change its settings.
+         */
+        template <int Index>
+        inline auto& getProcessor() {
+            return std::get<Index>(processors);
+        }
+
+        static constexpr int getNumFeedbackProcessors() {
+            return (int) sizeof...(Processors);
+        }
+
+    protected:
+        float feedback = 0;
+        std::tuple<Processors...> processors;
+
+        /**
+         Applies the chain and the feedback gain to a sample.
+         */
+        inline float applyFeedback(float samp) {
+            std::apply([&samp](auto&... processor) {
+                ((samp = processSample(processor, samp)), ...);
+            }, processors);
+            return flushDenormal(samp * feedback);
+        }
+
+        /**
+         Applies the chain and the feedback gain to a block,
+         one processor at a time.
+         */
+        inline void applyFeedbackBlock(float* data, int numSamples) {
+            std::apply([data, numSamples](auto&... processor) {
+                (processBlock(processor, data, numSamples), ...);
+            }, processors);
+            const float gain = feedback;
+            for(int i = 0; i < numSamples; i++) {
+                data[i] = flushDenormal(data[i] * gain);
+            }
+        }
+
+    private:
+        template <typename P>
+        static inline float processSample(P& processor, float samp) {
+            if constexpr (HasProcessSample<P>::value) return processor.processSample(samp);
+            else return processor(samp);
+        }
+
+        template <typename P>
+        static inline void processBlock(P& processor, float* data, int numSamples) {
+            if constexpr (HasProcessBlock<P>::value) {
+                processor.processBlock(data, numSamples);
+            }
+            else {
+                for(int i = 0; i < numSamples; i++) {
+                    data[i] = processSample(processor, data[i]);
+                }
+            }
+        }
+    };
+
+    /**
+     Makes a Chain from the given processors (copied or moved in).
+     */
+    template <typename... Processors>
+    Chain<typename std::decay<Processors>::type...> makeChain(Processors&&... processors) {
+        return Chain<typename std::decay<Processors>::type...> (std::forward<Processors>(processors)...);
+    }
+}
+
+
+#endif /* DelayFeedback_h */
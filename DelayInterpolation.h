@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    DelayInterpolation.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Interpolation policies for reading between samples of a delay line
+    (the Interpolation parameter of PALdsp::CircularBuffer).
+    Each one reads `taps` consecutive samples, starting `before` samples
+    earlier than the integer read position, and interpolates at a
+    fraction frac (0 <= frac < 1) past that position. The buffer gathers
+    the taps (or points straight into mirrored memory), so policies
+    never wrap.
+
+    Roughly in order of cost (and quality):
+    - None: nearest earlier sample.
+    - Linear: 2 taps. Cheap, but a fractional delay near 0.5 dulls the
+      top octave and modulation adds zipper-like artefacts.
+    - Hermite: 4-point cubic Hermite (Catmull-Rom); a good default for
+      chorus/flanger.
+    - Lagrange<4>, Lagrange<6>: maximally flat FIR fractional delay.
+    - Thiran: first-order allpass. Flat magnitude (no high-frequency loss)
+      but it has state, so it suits slow modulation only; it can tick
+      when the read position crosses a whole sample.
+    - WindowedSinc<Taps, Phases>: table-driven Blackman-windowed sinc,
+      the most accurate at high frequencies.
+
+    The buffers and AllPassFilter use PALDSP_DELAY_INTERPOLATION (Linear
+    by default); define it before including to change it for all of them.
+
+  ==============================================================================
+*/
+
+#ifndef DelayInterpolation_h
+#define DelayInterpolation_h
+
+#include <math.h>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define PALDSP_DELAYINTERPOLATION_SSE 1
+#endif
+
+#ifndef PI
+#define PI      3.14159265358979323846
+#endif
+
+namespace DelayInterpolation {
+
+    /**
+     Reads the nearest earlier sample (fraction ignored).
+     */
+    struct None {
+        static constexpr int before = 0;
+        static constexpr int taps = 1;
+
+        static inline float interpolate(const float* x, float frac) {
+            (void) frac;
+            return x[0];
+        }
+    };
+
+    /**
+     Linear interpolation between the two samples either side.
+     */
+    struct Linear {
+        static constexpr int before = 0;
+        static constexpr int taps = 2;
+
+        static inline float interpolate(const float* x, float frac) {
+            return x[0] + frac * (x[1] - x[0]);
+        }
+    };
+
+    /**
+     4-point, 3rd-order cubic Hermite (Catmull-Rom) interpolation
+     between x[1] and x[2].
+     */
+    struct Hermite {
+        static constexpr int before = 1;
+        static constexpr int taps = 4;
+
+        static inline float interpolate(const float* x, float frac) {
+            const float c1 = 0.5f * (x[2] - x[0]);
+            const float c2 = x[0] - 2.5f * x[1] + 2.0f * x[2] - 0.5f * x[3];
+            const float c3 = 0.5f * (x[3] - x[0]) + 1.5f * (x[1] - x[2]);
+            return ((c3 * frac + c2) * frac + c1) * frac + x[1];
+        }
+    };
+
+    /**
+     Points-point Lagrange interpolation (order Points - 1), centred on
+     the interval being read. The weights are built from running prefix
+     and suffix products, so they cost O(Points) rather than O(Points^2).
+     The 4 and 6-point versions are specialised below.
+     */
+    template <int Points>
+    struct Lagrange {
+        static_assert(Points >= 2 && Points % 2 == 0, "Lagrange needs an even number of points");
+
+        static constexpr int before = Points / 2 - 1;
+        static constexpr int taps = Points;
+
+        static inline float interpolate(const float* x, float frac) {
+            const float t = frac + before; // position measured from x[0]
+
+            float prefix[Points], suffix[Points];
+            prefix[0] = 1;
+            for(int k = 1; k < Points; k++) {
+                prefix[k] = prefix[k - 1] * (t - (k - 1));
+            }
+            suffix[Points - 1] = 1;
+            for(int k = Points - 2; k >= 0; k--) {
+                suffix[k] = suffix[k + 1] * (t - (k + 1));
+            }
+
+            float sum = 0;
+            for(int k = 0; k < Points; k++) {
+                sum += x[k] * (prefix[k] * suffix[k] * inverseDenominators[k]);
+            }
+            return sum;
+        }
+
+    private:
+        /** 1 / prod(k - j) over j != k, for each point k. */
+        static constexpr std::array<float, Points> makeInverseDenominators() {
+            std::array<float, Points> result {};
+            for(int k = 0; k < Points; k++) {
+                double d = 1;
+                for(int j = 0; j < Points; j++) {
+                    if(j != k) d *= (double) (k - j);
+                }
+                result[k] = (float) (1.0 / d);
+            }
+            return result;
+        }
+
+        static constexpr std::array<float, Points> inverseDenominators = makeInverseDenominators();
+    };
+
+    /**
+     4-point (cubic) Lagrange interpolation between x[1] and x[2], with
+     the weights written out as products of (frac - j) that share their
+     common factors. The general form's prefix and suffix arrays end up
+     in memory, which made this several times the cost of Hermite.
+     */
+    template <>
+    struct Lagrange<4> {
+        static constexpr int before = 1;
+        static constexpr int taps = 4;
+
+        static inline float interpolate(const float* x, float frac) {
+            const float dp1 = frac + 1.0f;
+            const float dm1 = frac - 1.0f;
+            const float dm2 = frac - 2.0f;
+            const float a = frac * dm1;
+            const float b = dp1 * dm2;
+            return (a * dm2) * (-1.0f / 6.0f) * x[0]
+                 + (b * dm1) * 0.5f * x[1]
+                 + (b * frac) * -0.5f * x[2]
+                 + (a * dp1) * (1.0f / 6.0f) * x[3];
+        }
+    };
+
+    /**
+     6-point (quintic) Lagrange interpolation between x[2] and x[3],
+     written out the same way: each weight is the product of five of
+     the six factors (frac + 2 - k), built from three shared pairs.
+     */
+    template <>
+    struct Lagrange<6> {
+        static constexpr int before = 2;
+        static constexpr int taps = 6;
+
+        static inline float interpolate(const float* x, float frac) {
+            const float f0 = frac + 2.0f, f1 = frac + 1.0f, f2 = frac;
+            const float f3 = frac - 1.0f, f4 = frac - 2.0f, f5 = frac - 3.0f;
+            const float p01 = f0 * f1, p23 = f2 * f3, p45 = f4 * f5;
+            const float q = p23 * p45, r = p01 * p45, s = p01 * p23;
+            return (f1 * q) * (-1.0f / 120.0f) * x[0]
+                 + (f0 * q) * (1.0f / 24.0f) * x[1]
+                 + (f3 * r) * (-1.0f / 12.0f) * x[2]
+                 + (f2 * r) * (1.0f / 12.0f) * x[3]
+                 + (f5 * s) * (-1.0f / 24.0f) * x[4]
+                 + (f4 * s) * (1.0f / 120.0f) * x[5];
+        }
+    };
+
+    typedef Lagrange<4> Lagrange4;
+    typedef Lagrange<6> Lagrange6;
+
+    /**
+     First-order Thiran allpass fractional delay.
+     The delay behind the newest tap is kept between 1 and 2 samples,
+     where the filter is well behaved. Stateful: one per delay line.
+     */
+    class Thiran {
+    public:
+        static constexpr int before = 0;
+        static constexpr int taps = 3;
+
+        inline float interpolate(const float* x, float frac) {
+            const float d = 2.0f - frac; // delay behind x[2]
+            const float a = (1.0f - d) / (1.0f + d);
+            const float y = a * x[2] + x[1] - a * previous;
+            previous = y;
+            return y;
+        }
+
+    private:
+        float previous = 0;
+    };
+
+    /**
+     Table-driven windowed-sinc interpolation with Taps points.
+     The weights for Phases + 1 evenly spaced fractions are tabulated
+     (and normalised to unity gain at DC); the weights for the fraction
+     actually read are linearly interpolated between the two nearest
+     rows, then applied with a SIMD dot product.
+
+     The table is shared by every user and built on first use. Call
+     getTable() once off the audio thread (e.g. in prepare) to avoid
+     building it while processing.
+     */
+    template <int Taps = 8, int Phases = 256>
+    struct WindowedSinc {
+        static_assert(Taps >= 4 && Taps % 4 == 0, "WindowedSinc needs a multiple of 4 taps");
+
+        static constexpr int before = Taps / 2 - 1;
+        static constexpr int taps = Taps;
+
+        static inline float interpolate(const float* x, float frac) {
+            const float position = frac * Phases;
+            // frac can round up to exactly 1 (offset - floorf(offset) for a tiny
+            // negative offset): use the last pair of rows with blend = 1
+            const int phase = std::min((int) position, Phases - 1);
+            const float blend = position - (float) phase;
+            const float* row0 = getTable() + phase * Taps;
+            const float* row1 = row0 + Taps;
+
+#if defined(PALDSP_DELAYINTERPOLATION_SSE)
+            const __m128 vBlend = _mm_set1_ps(blend);
+            __m128 acc = _mm_setzero_ps();
+            for(int k = 0; k < Taps; k += 4) {
+                const __m128 w0 = _mm_loadu_ps(row0 + k);
+                const __m128 w1 = _mm_loadu_ps(row1 + k);
+                const __m128 w = _mm_add_ps(w0, _mm_mul_ps(vBlend, _mm_sub_ps(w1, w0)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(w, _mm_loadu_ps(x + k)));
+            }
+            // horizontal sum
+            acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+            acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+            return _mm_cvtss_f32(acc);
+#else
+            float sum = 0;
+            for(int k = 0; k < Taps; k++) {
+                sum += x[k] * (row0[k] + blend * (row1[k] - row0[k]));
+            }
+            return sum;
+#endif
+        }
+
+        /**
+         Returns the (Phases + 1) x Taps weight table, building it if needed.
+         */
+        static const float* getTable() {
+            static const std::vector<float> table = makeTable();
+            return table.data();
+        }
+
+    private:
+        static std::vector<float> makeTable() {
+            std::vector<float> table((Phases + 1) * Taps);
+            for(int p = 0; p <= Phases; p++) {
+                const double frac = (double) p / Phases;
+                double sum = 0;
+                for(int k = 0; k < Taps; k++) {
+                    const double t = (k - before) - frac; // tap distance from the read point
+                    const double sinc = (t == 0) ? 1.0 : sin(PI * t) / (PI * t);
+                    // Blackman window spanning -Taps/2 .. Taps/2
+                    const double n = (t + Taps / 2.0) / Taps;
+                    const double window = 0.42 - 0.5 * cos(2 * PI * n) + 0.08 * cos(4 * PI * n);
+                    table[p * Taps + k] = (float) (sinc * window);
+                    sum += sinc * window;
+                }
+                for(int k = 0; k < Taps; k++) {
+                    table[p * Taps + k] = (float) (table[p * Taps + k] / sum);
+                }
+            }
+            return table;
+        }
+    };
+}
+
+#ifndef PALDSP_DELAY_INTERPOLATION
+ #define PALDSP_DELAY_INTERPOLATION DelayInterpolation::Linear
+#endif
+
+
+#endif /* DelayInterpolation_h */
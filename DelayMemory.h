@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    DelayMemory.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    The sample storage behind the circular buffers. The size is always a
+    power of two (so the buffers can keep wrapping with a mask), chosen
+    as the next one above the longest delay the line needs, rather than
+    a fixed worst-case array.
+
+    Storage comes from a DelayArena if one is given, otherwise it is
+    owned on the heap. Copying a DelayMemory always makes an owned copy
+    of the samples, so copied filters never share a delay line.
+
+    FixedDelayMemory<Size> is the compile-time alternative: the samples
+    live inside the object and the mask is a constant, for short lines
+    whose maximum length is known up front.
+
+  ==============================================================================
+*/
+
+#ifndef DelayMemory_h
+#define DelayMemory_h
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "DelayArena.h"
+
+class DelayMemory {
+public:
+
+    DelayMemory(){}
+
+    /**
+     Allocates (cleared) storage for a delay of up to maxDelaySamples.
+     */
+    DelayMemory(int maxDelaySamples, DelayArena* arena = nullptr) {
+        allocate(maxDelaySamples, arena);
+    }
+
+    DelayMemory(const DelayMemory& other) {
+        copyFrom(other);
+    }
+
+    DelayMemory(DelayMemory&& other) noexcept {
+        moveFrom(other);
+    }
+
+    DelayMemory& operator=(const DelayMemory& other) {
+        if(this != &other) copyFrom(other);
+        return *this;
+    }
+
+    DelayMemory& operator=(DelayMemory&& other) noexcept {
+        if(this != &other) moveFrom(other);
+        return *this;
+    }
+
+    ~DelayMemory(){};
+
+    /**
+     (Re)allocates cleared storage for a delay of up to maxDelaySamples,
+     from the arena if given, otherwise on the heap.
+     Allocates, so call it off the audio thread.
+     */
+    void allocate(int maxDelaySamples, DelayArena* arena = nullptr) {
+        size = DelayArena::getDelayCapacity(maxDelaySamples);
+        data = (arena != nullptr) ? arena->allocate(size) : nullptr;
+
+        if(data != nullptr) {
+            std::vector<float>().swap(owned);
+            clear(); // arena blocks may hold an earlier user's samples
+        }
+        else {
+            // no arena (or it ran out): own the memory instead
+            // (assign already zeroes it)
+            owned.assign(size, 0.0f);
+            data = owned.data();
+        }
+    }
+
+    /**
+     Sets all samples to 0
+     */
+    inline void clear() {
+        std::fill_n(data, size, 0.0f);
+    }
+
+    inline float& operator[](int index) {
+        return data[index];
+    }
+
+    inline const float& operator[](int index) const {
+        return data[index];
+    }
+
+    inline float* getData() {
+        return data;
+    }
+
+    /** The (power-of-two) number of samples. */
+    inline int getSize() const {
+        return size;
+    }
+
+    /** The mask for wire-and wrapping (size - 1). */
+    inline int getMask() const {
+        return size - 1;
+    }
+
+    /** Reads past the end never continue at the start (see MirroredDelayMemory). */
+    static constexpr bool isMirrored() {
+        return false;
+    }
+
+private:
+    std::vector<float> owned;
+    float* data = nullptr;
+    int size = 0;
+
+    void copyFrom(const DelayMemory& other) {
+        owned.assign(other.data, other.data + other.size);
+        data = owned.data();
+        size = other.size;
+    }
+
+    void moveFrom(DelayMemory& other) {
+        // moving the vector keeps its heap block, so data stays valid
+        const bool otherOwns = (other.data == other.owned.data());
+        owned = std::move(other.owned);
+        data = otherOwns ? owned.data() : other.data;
+        size = other.size;
+        other.data = nullptr;
+        other.size = 0;
+    }
+};
+
+
+template <int Size>
+class FixedDelayMemory {
+public:
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "FixedDelayMemory size must be a power of two");
+
+    FixedDelayMemory(){}
+
+    /**
+     Checks that a delay of up to maxDelaySamples fits and clears
+     the samples. There is nothing to allocate, so the arena is ignored.
+     */
+    void allocate(int maxDelaySamples, DelayArena* arena = nullptr) {
+        (void) arena;
+        jassert(maxDelaySamples < Size);
+        clear();
+    }
+
+    inline void clear() {
+        std::fill_n(data, Size, 0.0f);
+    }
+
+    inline float& operator[](int index) {
+        return data[index];
+    }
+
+    inline const float& operator[](int index) const {
+        return data[index];
+    }
+
+    inline float* getData() {
+        return data;
+    }
+
+    static constexpr int getSize() {
+        return Size;
+    }
+
+    static constexpr int getMask() {
+        return Size - 1;
+    }
+
+    static constexpr bool isMirrored() {
+        return false;
+    }
+
+private:
+    float data[Size];
+};
+
+
+#endif /* DelayMemory_h */
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    Denormals.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Protection against subnormal (denormal) floats in feedback structures.
+    When a reverb tail or IIR filter decays towards silence its state
+    becomes subnormal, and on most CPUs every operation on it gets many
+    times slower.
+
+    Two tools, usually used together:
+    - ScopedDenormalFlush: RAII guard that turns on flush-to-zero and
+      denormals-are-zero (MXCSR on x86, FPCR/FPSCR on ARM) for the scope
+      of a process call, restoring the previous mode afterwards.
+    - flushDenormal(): a cheap branch-free in-loop flush, used by the
+      feedback paths in this library for platforms/hosts where the FP
+      mode can't be relied on. Define PALDSP_FLUSH_DENORMALS to 0 to
+      compile it out if you always process under a ScopedDenormalFlush.
+    The in-loop flush stops state from *staying* subnormal once a tail has
+    died away; only the FP mode also covers the brief stretch where tiny
+    (but normal) values produce subnormal intermediates, so prefer the
+    scope wherever you control the processing thread.
+
+  ==============================================================================
+*/
+
+#ifndef Denormals_h
+#define Denormals_h
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define PALDSP_HAS_MXCSR 1
+#endif
+
+#ifndef PALDSP_FLUSH_DENORMALS
+ #define PALDSP_FLUSH_DENORMALS 1
+#endif
+
+class ScopedDenormalFlush {
+public:
+
+    /**
+     Enables flush-to-zero / denormals-are-zero until this object
+     goes out of scope. Create one at the top of a processBlock call.
+     */
+    ScopedDenormalFlush() {
+#if defined(PALDSP_HAS_MXCSR)
+        previous = _mm_getcsr();
+        _mm_setcsr(previous | 0x8040); // FTZ (bit 15) | DAZ (bit 6)
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        uint64_t fpcr;
+        asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+        previous = fpcr;
+        asm volatile("msr fpcr, %0" : : "r"(fpcr | (1ull << 24))); // FZ
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+        uint32_t fpscr;
+        asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+        previous = fpscr;
+        asm volatile("vmsr fpscr, %0" : : "r"(fpscr | (1u << 24))); // FZ
+#endif
+    }
+
+    ~ScopedDenormalFlush() {
+#if defined(PALDSP_HAS_MXCSR)
+        _mm_setcsr((unsigned int) previous);
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        asm volatile("msr fpcr, %0" : : "r"(previous));
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+        asm volatile("vmsr fpscr, %0" : : "r"((uint32_t) previous));
+#endif
+    }
+
+    ScopedDenormalFlush(const ScopedDenormalFlush&) = delete;
+    ScopedDenormalFlush& operator=(const ScopedDenormalFlush&) = delete;
+
+private:
+    uint64_t previous = 0;
+};
+
+/**
+ Returns 0 if the given value is subnormal, otherwise the value itself.
+ Branch-free (a compare and select), so it is safe in inner loops.
+ */
+inline float flushDenormal(float value) {
+#if PALDSP_FLUSH_DENORMALS
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return ((bits & 0x7f800000u) == 0) ? 0.0f : value;
+#else
+    return value;
+#endif
+}
+
+inline double flushDenormal(double value) {
+#if PALDSP_FLUSH_DENORMALS
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return ((bits & 0x7ff0000000000000ull) == 0) ? 0.0 : value;
+#else
+    return value;
+#endif
+}
+
+
+#endif /* Denormals_h */
@@ -11,13 +11,18 @@
 #ifndef FeedbackCombFilter_h
 #define FeedbackCombFilter_h
 
-#include "CircularBufferShort.h"
+#include "CircularBuffer.h"
+#include "Denormals.h"
 
 class FeedbackCombFilter {
 public:
     
-    FeedbackCombFilter(int delay, float feedbackGain){
-        buffer.setLengthSamples(delay);
+    /**
+     A feedback comb filter with a given delay length (in samples).
+     The delay memory is taken from the arena if one is given.
+     */
+    FeedbackCombFilter(int delay, float feedbackGain, DelayArena* arena = nullptr)
+        : buffer (delay, 0, arena) {
         this->delay = delay;
         this->feedbackGain = feedbackGain;
     }
@@ -29,11 +34,36 @@ public:
      Returns the next sample.
      */
     inline float processSample(float input) {
-        float nextSamp = input + (buffer.getSample() * feedbackGain);
+        float nextSamp = flushDenormal(input + (buffer.getSample() * feedbackGain));
         buffer.pushSample(nextSamp);
         return nextSamp;
     }
     
+    /**
+     Process a block of samples through the filter.
+     Works directly on the delay memory, in runs that don't wrap.
+     in and out may point to the same buffer.
+     */
+    inline void processBlock(const float* in, float* out, int numSamples) {
+        const float gain = feedbackGain;
+        buffer.processSpans(numSamples, [&](const float* delayed, float* write, int offset, int n) {
+            const float* x = in + offset;
+            float* y = out + offset;
+            for(int i = 0; i < n; i++) {
+                float nextSamp = flushDenormal(x[i] + (delayed[i] * gain));
+                write[i] = nextSamp;
+                y[i] = nextSamp;
+            }
+        });
+    }
+    
+    /**
+     Process a block of samples through the filter in place.
+     */
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+    
     /* Set length of delay line. */
     inline void setDelay(int delay) {
         this-> delay = delay;
@@ -54,7 +84,7 @@ public:
     }
     
 private:
-    CircularBufferShort buffer { 1 }; // default buffer with length 1 sample
+    PALdsp::CircularBuffer<> buffer { 1 }; // default buffer with length 1 sample
     int delay;
     float feedbackGain;
 };
@@ -24,6 +24,17 @@ public:
         return(output);
     }
     
+    inline void processBlock(const float* input, float* output, int numSamples){
+        const float gain = gainVal;
+        for(int i = 0; i < numSamples; i++){
+            output[i] = input[i] * gain;
+        }
+    }
+    
+    inline void processBlock(float* data, int numSamples){
+        processBlock(data, data, numSamples);
+    }
+    
 private:
     float       gainVal;
 };
@@ -14,6 +14,7 @@
 */
 
 #include "Biquad.h"
+#include "StaticFilters.h"
 #ifndef HPF_h
 #define HPF_h
 
@@ -27,28 +28,15 @@ public:
     
     // constructor with default coefficients
     HPF(type filterType, float frequency, float Q, float wet = 1, float dry = 0) : Biquad (filterType, frequency, wet, dry) {
-        
-        // audio-eq-cookbook
-        double w0 = 2 * (frequency/44100) * PI;
-        double cosW0 = cos(w0);
-        double sinW0 = sin(w0);
-        double alpha = sinW0 / (Q * 2);
-        
-        b0 = (1 + cosW0) / 2;
-        b1 = -1 * (1 + cosW0);
-        b2 = (1 + cosW0) / 2;
-        a0 = 1 + alpha;
-        a1 = -2 * cosW0;
-        a2 = 1 - alpha;
+
+        this->Q = Q;
+        updateCoefficients();
     }
     
     inline float processSample(float samp){
         
         if(filterType == FIRSTORDER) {
-            float result = ((1 + bandWidth) / 2) * (samp - firstOrderDelayDry) + firstOrderDelayWet;
-            firstOrderDelayDry = samp;
-            firstOrderDelayWet = result;
-            return result;
+            return firstOrder.processSample(samp);
         }
         else if(filterType == BIQUAD) {
             return Biquad::processSample(samp);
@@ -56,14 +44,32 @@ public:
         else return 0.0f;
     }
 
+    using Biquad::processBlock;
+
+    void processBlock(const float* in, float* out, int numSamples) override {
+
+        if(filterType == FIRSTORDER) {
+            firstOrder.processBlock(in, out, numSamples);
+        }
+        else if(filterType == BIQUAD) {
+            Biquad::processBlock(in, out, numSamples);
+        }
+        else std::fill_n(out, numSamples, 0.0f);
+    }
+
     void setType(int newType) {
         filterType = newType;
     }
 
+protected:
+    BiquadCoefficients designCoefficients() const override {
+        // audio-eq-cookbook
+        return BiquadCoefficients::highpass(freq, Q, sampleRate);
+    }
+
 private:
-    double firstOrderDelayDry = 0;
-    double firstOrderDelayWet = 0;
-    double bandWidth = 1;
+    // first-order kernel (the biquad path runs on the Biquad base)
+    PALdsp::HPF<PALdsp::FirstOrder> firstOrder;
 };
 
 
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    HalfbandFilter.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    One 2x polyphase half-band FIR stage, used by Oversampler.
+    Every other tap of a half-band filter is zero (except the centre, 0.5),
+    so split into its two polyphase branches it becomes:
+    - a symmetric FIR of 2K taps, computed with K multiplies by adding
+      the mirrored pairs of samples first, and
+    - a pure delay.
+    Upsampling runs both branches at the low rate (no multiplies by
+    zero-stuffed samples); downsampling only computes the kept outputs.
+
+    Each stage has a round-trip (up + down) latency of 2K - 1 samples at
+    its input rate.
+
+  ==============================================================================
+*/
+
+#ifndef HalfbandFilter_h
+#define HalfbandFilter_h
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#ifndef PI
+#define PI      3.14159265358979323846
+#endif
+
+class HalfbandFilter {
+public:
+
+    /**
+     Creates a half-band stage with numPairs (K) symmetric coefficient pairs,
+     i.e. a 4K - 1 tap prototype. More pairs = steeper transition band.
+     The prototype is a Kaiser-windowed sinc.
+     */
+    HalfbandFilter(int numPairs, double kaiserBeta = 8.0) {
+        jassert(numPairs > 0);
+        K = numPairs;
+        L = 2 * K;
+
+        // polyphase branch taps g[j] = h[2j], centred on tap 2K - 1
+        std::vector<double> g(L);
+        double sum = 0;
+        for(int j = 0; j < L; j++) {
+            const double t = j - K + 0.5;             // (2j - c) / 2
+            const double sinc = sin(PI * t) / (PI * t);
+            const double pos = (2.0 * j - (L - 1)) / (double) L; // -1..1 over the prototype
+            g[j] = sinc * kaiser(pos, kaiserBeta);
+            sum += g[j];
+        }
+
+        // normalise so the branch sums to 0.5 (unity DC gain overall)
+        coefficients.resize(K);
+        for(int j = 0; j < K; j++) {
+            coefficients[j] = (float) (0.5 * g[j] / sum);
+        }
+
+        upHistory.assign(2 * L, 0.0f);
+        downEven.assign(2 * L, 0.0f);
+        downOdd.assign(2 * L, 0.0f);
+    }
+
+    ~HalfbandFilter(){};
+
+    /**
+     Upsamples numSamples into 2 * numSamples output samples.
+     */
+    void upsample(const float* in, float* out, int numSamples) {
+        const float* c = coefficients.data();
+
+        for(int i = 0; i < numSamples; i++) {
+            const float* x = push(upHistory, upIndex, in[i]); // x[-j] = newest - j
+
+            float acc = 0;
+            for(int j = 0; j < K; j++) {
+                acc += c[j] * (x[-j] + x[-(L - 1 - j)]);
+            }
+
+            out[2 * i] = 2.0f * acc;
+            out[2 * i + 1] = x[-(K - 1)];
+        }
+    }
+
+    /**
+     Downsamples 2 * numSamples input samples into numSamples output samples.
+     */
+    void downsample(const float* in, float* out, int numSamples) {
+        const float* c = coefficients.data();
+
+        for(int i = 0; i < numSamples; i++) {
+            const float* even = push(downEven, evenIndex, in[2 * i]);
+            const float* odd = push(downOdd, oddIndex, in[2 * i + 1]);
+
+            float acc = 0;
+            for(int j = 0; j < K; j++) {
+                acc += c[j] * (even[-j] + even[-(L - 1 - j)]);
+            }
+
+            out[i] = acc + 0.5f * odd[-K];
+        }
+    }
+
+    void reset() {
+        std::fill(upHistory.begin(), upHistory.end(), 0.0f);
+        std::fill(downEven.begin(), downEven.end(), 0.0f);
+        std::fill(downOdd.begin(), downOdd.end(), 0.0f);
+        upIndex = evenIndex = oddIndex = 0;
+    }
+
+    /**
+     Round-trip latency in samples at this stage's input rate.
+     */
+    inline int getLatency() {
+        return L - 1;
+    }
+
+    /**
+     The Kaiser window at pos (-1 to 1 across the window).
+     Also used to design Resampler's filters.
+     */
+    static double kaiser(double pos, double beta) {
+        return besselI0(beta * sqrt(std::max(0.0, 1 - pos * pos))) / besselI0(beta);
+    }
+
+    static double besselI0(double x) {
+        double sum = 1, term = 1;
+        for(int k = 1; k < 50; k++) {
+            term *= (x / (2 * k)) * (x / (2 * k));
+            sum += term;
+            if(term < 1e-12 * sum) break;
+        }
+        return sum;
+    }
+
+private:
+    int K; // number of symmetric pairs
+    int L; // taps in the FIR branch (2K)
+    std::vector<float> coefficients; // first half of the symmetric branch
+
+    // histories are written twice (at i and i + L) so the last L samples
+    // are always contiguous and never need wrapping
+    std::vector<float> upHistory, downEven, downOdd;
+    int upIndex = 0, evenIndex = 0, oddIndex = 0;
+
+    /**
+     Pushes a sample and returns a pointer to it; older samples
+     are at negative offsets (down to -(L - 1)).
+     */
+    inline const float* push(std::vector<float>& history, int& index, float sample) {
+        history[index] = sample;
+        history[index + L] = sample;
+        const float* newest = &history[index + L];
+        if(++index == L) index = 0;
+        return newest;
+    }
+};
+
+
+#endif /* HalfbandFilter_h */
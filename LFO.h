@@ -5,13 +5,35 @@
     Created: 3 Apr 2022 9:36:09pm
     Author:  Peter Liley
  
-    Creates an LFO that should be called every sample.
+    Creates an LFO that should be called every sample
+    (or a block at a time, with nextBlock).
+
+    The phase is a 64-bit fixed-point accumulator, so any frequency is
+    kept exactly rather than rounded to whole samples per cycle.
+
+    Besides the periodic waveforms there are random modes, each LFO
+    drawing from its own NoiseGenerator (see setSeed):
+    - RANDOM: sample-and-hold, a new random value every cycle.
+    - SMOOTH_RANDOM: glides (smoothstep) to a new random value every cycle.
+    - WHITE_NOISE, PINK_NOISE: a new noise sample every sample.
+    The random modes run from 0 to 1 before mapping.
 
   ==============================================================================
 */
 
 #ifndef LFO_h
 #define LFO_h
+
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include "NoiseGenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define PALDSP_LFO_SSE2 1
+#endif
+
 #define PI      3.14159265358979323846
 using namespace juce;
 
@@ -23,7 +45,10 @@ public:
         TRIANGLE,
         SQUARE,
         SAW,
-        RANDOM
+        RANDOM,
+        SMOOTH_RANDOM,
+        WHITE_NOISE,
+        PINK_NOISE
     };
     
     /**
@@ -31,33 +56,19 @@ public:
      and a default sample rate of 44.1kHz.
      NB: You should definitely change the sample rate to match the host
      in the prepareToPlay function!*/
-    LFO(){
-        this->sampleRate = 44100;
-        this->frequency = 1;
-        this->samplesPerCycle = sampleRate * frequency;
-        this->currProgress = 0;
-        this->currOscillator = Oscillator::SINE;
-    }
+    LFO() : LFO (44100, 1) {}
     
     /**
      Creates a sine-wave LFO with a default frequency of 1Hz.
      The amplitude range of this LFO is  0 - 1.
      */
-    LFO(int sampleRate){
-        LFO();
-        this->sampleRate = sampleRate;
-    }
+    LFO(int sampleRate) : LFO (sampleRate, 1) {}
     
     /**
      Creates a sine-wave LFO with a custom frequency (in Hz).
      The amplitude range of this LFO is  0 - 1.
      */
-    LFO(int sampleRate, float frequency){
-        LFO();
-        this->sampleRate = sampleRate;
-        this->frequency = frequency;
-        this->samplesPerCycle = (int) sampleRate / frequency;
-    }
+    LFO(int sampleRate, float frequency) : LFO (sampleRate, frequency, Oscillator::SINE) {}
     
     /**
      Creates a custom-wave LFO with a custom frequency (in Hz).
@@ -66,21 +77,18 @@ public:
     LFO(int sampleRate, float frequency, LFO::Oscillator osc){
         this->sampleRate = sampleRate;
         this->frequency = frequency;
-        this->samplesPerCycle = (int) (sampleRate / frequency);
-        this->currProgress = 0;
         this->currOscillator = osc;
+        updateIncrement();
+        randomPrevious = unipolar(noise.nextWhite());
+        randomNext = unipolar(noise.nextWhite());
     }
     
     /**
      Creates a custom-wave LFO with a custom frequency (in Hz).
      The amplitude range of this LFO is  0 - 1.
      */
-    LFO(int sampleRate, float frequency, LFO::Oscillator osc, float min, float max){
-        this->sampleRate = sampleRate;
-        this->frequency = frequency;
-        this->samplesPerCycle = (int) (sampleRate / frequency);
-        this->currProgress = 0;
-        this->currOscillator = osc;
+    LFO(int sampleRate, float frequency, LFO::Oscillator osc, float min, float max)
+        : LFO (sampleRate, frequency, osc) {
         this->min = min;
         this->max = max;
     }
@@ -100,8 +108,7 @@ public:
     inline void setfrequency(float frequency){
         if(frequency <= 0) jassertfalse;
         this->frequency = frequency;
-        // set samples per cycle according to sample rate
-        this->samplesPerCycle = (int) (sampleRate / frequency);
+        updateIncrement();
     }
     
     /**
@@ -109,7 +116,7 @@ public:
      */
     inline void setSampleRate(int rate){
         sampleRate = rate;
-        samplesPerCycle = (int) (sampleRate / frequency);
+        updateIncrement();
     }
     
     /**
@@ -126,6 +133,7 @@ public:
     inline void setPhase(float phase) {
         jassert(phase <= 1 && phase >= 0);
         phaseVal = phase;
+        phaseOffset = toFixedPoint(phase);
     }
     
     /**
@@ -135,24 +143,30 @@ public:
         return phaseVal;
     }
     
+    /**
+     Restarts the random modes' stream from a given seed, for
+     repeatable random modulation. (Every LFO starts with a seed
+     of its own, so separate LFOs are uncorrelated.)
+     */
+    inline void setSeed(uint32_t seed) {
+        noise.setSeed(seed);
+        randomPrevious = unipolar(noise.nextWhite());
+        randomNext = unipolar(noise.nextWhite());
+    }
+    
     /**
      Get the value at the current point the LFO cycle.
      */
     inline float getValue(float phase = 0){
+        uint64_t offset = phaseOffset;
         if(phaseVal == 0) {
             // cheack the phase is within 0-1
             jassert(phase <= 1 && phase >= 0);
-            phase = (phase > 1 || phase < 0) ? 0 : phase;
+            offset = (phase > 1 || phase < 0) ? 0 : toFixedPoint(phase);
         }
-        else phase = phaseVal;
         
-        // get the current progress as a float value from 0 - 1
-        float progress = (float) currProgress / (float) samplesPerCycle;
-        // phase-offset
-        if(phase != 0){
-            progress += phase;
-            progress = (progress > 1) ? progress - 1 : progress;
-        }
+        // the current progress (plus phase offset) as a float value from 0 - 1
+        float progress = toProgress(currProgress + offset);
         
         switch (currOscillator) {
             case Oscillator::SINE:
@@ -168,7 +182,14 @@ public:
                 return saw(progress);
                 break;
             case Oscillator::RANDOM:
-                return rand(progress);
+                return randomNext;
+                break;
+            case Oscillator::SMOOTH_RANDOM:
+                return SmoothRandomShape { randomPrevious, randomNext }.process(progress);
+                break;
+            case Oscillator::WHITE_NOISE:
+            case Oscillator::PINK_NOISE:
+                return noiseValue;
                 break;
             default:
                 return 0.0;
@@ -179,53 +200,314 @@ public:
      Generates and returns the next sample value for the current LFO.
      */
     inline float next(){
-        // SPEEDUP
-        // increment the progress through the cycle in samples
-        currProgress = (currProgress + 1) % samplesPerCycle;
+        // increment the progress through the cycle
+        const uint64_t previous = currProgress + phaseOffset;
+        currProgress += increment;
+        if(currOscillator >= Oscillator::RANDOM) {
+            updateRandom(currProgress + phaseOffset < previous ? 1 : 0);
+        }
         
         // and get the value (mapped if relevant)
         return jmap(getValue(), min, max);
     }
     
-private:
+    /**
+     Moves the LFO on by numSamples without generating them, e.g. to
+     evaluate it at a control rate: advance(n) then getValue() gives
+     the value n calls to next() would end on.
+     */
+    inline void advance(int numSamples){
+        if(currOscillator < Oscillator::RANDOM) {
+            currProgress += (uint64_t) numSamples * increment;
+            return;
+        }
+        if(currOscillator >= Oscillator::WHITE_NOISE) {
+            skipNoise(numSamples);
+            currProgress += (uint64_t) numSamples * increment;
+            return;
+        }
+        
+        // count the cycles completed: numSamples * increment is up to
+        // 96 bits, so add it in 32-bit halves and count the carries
+        const uint64_t low = (uint64_t) numSamples * (increment & 0xffffffffu);
+        const uint64_t high = (uint64_t) numSamples * (increment >> 32);
+        uint64_t p = currProgress + phaseOffset;
+        int cycles = (int) (high >> 32);
+        p += low;
+        cycles += (p < low) ? 1 : 0;
+        p += high << 32;
+        cycles += (p < (high << 32)) ? 1 : 0;
+        currProgress = p - phaseOffset;
+        // draw every value next() would have, so the stream carries on from the same place
+        updateRandom(cycles);
+    }
+    
+    /**
+     Generates the next numSamples values (mapped to the range) into
+     out, as that many calls to next() would. The oscillator type is
+     resolved once for the block, and each waveform has its own loop
+     (four samples at a time with SSE2).
+     */
+    inline void nextBlock(float* out, int numSamples){
+        switch (currOscillator) {
+            case Oscillator::SINE:
+                generate(out, numSamples, SineShape());
+                break;
+            case Oscillator::TRIANGLE:
+                generate(out, numSamples, TriangleShape());
+                break;
+            case Oscillator::SQUARE:
+                generate(out, numSamples, SquareShape());
+                break;
+            case Oscillator::SAW:
+                generate(out, numSamples, SawShape());
+                break;
+            case Oscillator::RANDOM:
+            case Oscillator::SMOOTH_RANDOM:
+                generateRandom(out, numSamples);
+                break;
+            case Oscillator::WHITE_NOISE:
+            case Oscillator::PINK_NOISE:
+                generateNoise(out, numSamples);
+                break;
+            default:
+                std::fill_n(out, numSamples, 0.0f);
+        }
+    }
+    
+protected:
+    friend class LFOBank; // shares the phase format and waveforms
+    
     // FIELDS =================
     
     int sampleRate; // host sample frequency
     float frequency; // in Hz
-    int samplesPerCycle; // number of samples in an LFO cycle
-    int currProgress; // progress through the LFO cycle (in samples)
+    // progress through the LFO cycle, as a 64-bit fraction of a cycle
+    // (wraps by itself, and never drifts from the set frequency)
+    uint64_t currProgress = 0;
+    uint64_t increment; // progress per sample
     unsigned int currOscillator; // the type of oscillator
-    int phaseVal = 0;
+    float phaseVal = 0;
+    uint64_t phaseOffset = 0; // phaseVal as a fraction of a cycle
     
     float min = 0;
     float max = 1;
     
+    // random modes
+    NoiseGenerator noise;
+    float randomPrevious = 0; // the value this cycle glides from
+    float randomNext = 0; // the value it glides to (or holds)
+    float noiseValue = 0.5f; // the last noise sample (0 - 1)
+    
     // FUNCTIONS =================
-
+    
+    inline void updateIncrement(){
+        jassert(frequency < sampleRate);
+        increment = toFixedPoint((double) frequency / sampleRate);
+    }
+    
+    static inline uint64_t toFixedPoint(double cycles){
+        const double oneCycle = 18446744073709551616.0; // 2^64
+        const double scaled = (cycles - floor(cycles)) * oneCycle;
+        return (scaled >= oneCycle) ? 0 : (uint64_t) scaled;
+    }
+    
+    static inline float toProgress(uint64_t fixedPoint){
+        // the top 24 bits convert to float exactly
+        return (float) (int) (fixedPoint >> 40) * (1.0f / 16777216.0f);
+    }
+    
+    /**
+     Advances numSamples, writing shape.process(progress) mapped to
+     the range. With SSE2 four samples are made at a time: two pairs
+     of 64-bit phases, whose top 24 bits are packed into floats.
+     */
+    template <typename Shape>
+    inline void generate(float* out, int numSamples, const Shape& shape){
+        const float lo = min;
+        const float range = max - min;
+        uint64_t p = currProgress + phaseOffset;
+        int i = 0;
+#if defined(PALDSP_LFO_SSE2)
+        const __m128i step = _mm_set1_epi64x((long long) (4 * increment));
+        __m128i p01 = _mm_set_epi64x((long long) (p + 2 * increment), (long long) (p + increment));
+        __m128i p23 = _mm_set_epi64x((long long) (p + 4 * increment), (long long) (p + 3 * increment));
+        const __m128 vLo = _mm_set1_ps(lo);
+        const __m128 vRange = _mm_set1_ps(range);
+        const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+        for(; i + 4 <= numSamples; i += 4){
+            const __m128 top01 = _mm_castsi128_ps(_mm_srli_epi64(p01, 40));
+            const __m128 top23 = _mm_castsi128_ps(_mm_srli_epi64(p23, 40));
+            const __m128i top = _mm_castps_si128(_mm_shuffle_ps(top01, top23, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128 progress = _mm_mul_ps(_mm_cvtepi32_ps(top), scale);
+            _mm_storeu_ps(out + i, _mm_add_ps(vLo, _mm_mul_ps(shape.process(progress), vRange)));
+            p01 = _mm_add_epi64(p01, step);
+            p23 = _mm_add_epi64(p23, step);
+        }
+        p += (uint64_t) i * increment;
+#endif
+        for(; i < numSamples; i++){
+            p += increment;
+            out[i] = lo + shape.process(toProgress(p)) * range;
+        }
+        currProgress = p - phaseOffset;
+    }
     
     //Parabolic sinewave approx (Martijn 2019 via Jim Murphy 2022)
-    inline float fastSin(float progressFloat){
+    static inline float fastSin(float progressFloat){
         if (progressFloat > 0.5)
             progressFloat -= 1.0f;
-        return(progressFloat * (8 - (16 * abs(progressFloat))));
+        return(progressFloat * (8 - (16 * fabsf(progressFloat))));
     }
     
-    inline float tri(float progressFloat){
+    static inline float tri(float progressFloat){
         return (progressFloat <= 0.5) ? progressFloat * 2 : (1 - progressFloat) * 2;
     }
     
-    inline float sqr(float progressFloat){
+    static inline float sqr(float progressFloat){
         return (progressFloat <= 0.5) ? 1 : 0;
     }
     
-    inline float saw(float progressFloat){
+    static inline float saw(float progressFloat){
         return progressFloat;
     }
     
-    inline float rand(float progressFloat){
-        // TODO
-        return 0.1f;
+    static inline float unipolar(float white){
+        return 0.5f + 0.5f * white;
+    }
+    
+    /**
+     Moves the random modes on after a step in which numCycles
+     cycles were completed.
+     */
+    inline void updateRandom(int numCycles){
+        if(currOscillator == Oscillator::WHITE_NOISE) {
+            noiseValue = unipolar(noise.nextWhite());
+        }
+        else if(currOscillator == Oscillator::PINK_NOISE) {
+            noiseValue = unipolar(noise.nextPink());
+        }
+        else {
+            for(int i = 0; i < numCycles; i++) {
+                randomPrevious = randomNext;
+                randomNext = unipolar(noise.nextWhite());
+            }
+        }
+    }
+    
+    /**
+     The sample-and-hold and smooth random blocks: vectorised runs
+     between the cycle boundaries, with next() on each boundary.
+     */
+    inline void generateRandom(float* out, int numSamples){
+        int done = 0;
+        while(done < numSamples) {
+            // calls to next() before the one that completes the cycle
+            const uint64_t untilWrap = (increment == 0) ? UINT64_MAX : ~(currProgress + phaseOffset) / increment;
+            const int n = (int) std::min(untilWrap, (uint64_t) (numSamples - done));
+            if(currOscillator == Oscillator::RANDOM) generate(out + done, n, HeldShape { randomNext });
+            else generate(out + done, n, SmoothRandomShape { randomPrevious, randomNext });
+            done += n;
+            if(done < numSamples) {
+                out[done++] = next();
+            }
+        }
+    }
+    
+    /**
+     Moves the noise modes on by numSamples: the same draws (and pink
+     filter steps) as that many calls to next(), made a block at a time.
+     */
+    inline void skipNoise(int numSamples){
+        float skipped[64];
+        while(numSamples > 0) {
+            const int n = std::min(numSamples, 64);
+            if(currOscillator == Oscillator::WHITE_NOISE) noise.nextWhiteBlock(skipped, n);
+            else noise.nextPinkBlock(skipped, n);
+            noiseValue = unipolar(skipped[n - 1]);
+            numSamples -= n;
+        }
+    }
+    
+    /**
+     The noise blocks, made a block at a time by the noise generator.
+     */
+    inline void generateNoise(float* out, int numSamples){
+        if(numSamples <= 0) return;
+        if(currOscillator == Oscillator::WHITE_NOISE) noise.nextWhiteBlock(out, numSamples);
+        else noise.nextPinkBlock(out, numSamples);
+        noiseValue = unipolar(out[numSamples - 1]);
+        
+        const float lo = min;
+        const float range = max - min;
+        for(int i = 0; i < numSamples; i++) {
+            out[i] = lo + unipolar(out[i]) * range;
+        }
+        currProgress += (uint64_t) numSamples * increment;
     }
+    
+    // The waveforms for nextBlock, per sample and (with SSE2) four at a
+    // time, giving the same values as the functions above.
+    
+    struct SineShape {
+        static inline float process(float p) { return fastSin(p); }
+#if defined(PALDSP_LFO_SSE2)
+        static inline __m128 process(__m128 p) {
+            const __m128 wrapped = _mm_sub_ps(p, _mm_and_ps(_mm_cmpgt_ps(p, _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f)));
+            const __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), wrapped);
+            return _mm_mul_ps(wrapped, _mm_sub_ps(_mm_set1_ps(8.0f), _mm_mul_ps(_mm_set1_ps(16.0f), magnitude)));
+        }
+#endif
+    };
+    
+    struct TriangleShape {
+        static inline float process(float p) { return tri(p); }
+#if defined(PALDSP_LFO_SSE2)
+        static inline __m128 process(__m128 p) {
+            // 2p up to 0.5, 2(1 - p) after: twice the smaller of the two
+            return _mm_mul_ps(_mm_min_ps(p, _mm_sub_ps(_mm_set1_ps(1.0f), p)), _mm_set1_ps(2.0f));
+        }
+#endif
+    };
+    
+    struct SquareShape {
+        static inline float process(float p) { return sqr(p); }
+#if defined(PALDSP_LFO_SSE2)
+        static inline __m128 process(__m128 p) {
+            return _mm_and_ps(_mm_cmple_ps(p, _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f));
+        }
+#endif
+    };
+    
+    struct SawShape {
+        static inline float process(float p) { return saw(p); }
+#if defined(PALDSP_LFO_SSE2)
+        static inline __m128 process(__m128 p) { return p; }
+#endif
+    };
+    
+    struct HeldShape {
+        float value;
+        
+        inline float process(float p) const { (void) p; return value; }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 process(__m128 p) const { (void) p; return _mm_set1_ps(value); }
+#endif
+    };
+    
+    struct SmoothRandomShape {
+        float from, to;
+        
+        inline float process(float p) const {
+            return from + (to - from) * (p * p * (3.0f - 2.0f * p));
+        }
+#if defined(PALDSP_LFO_SSE2)
+        inline __m128 process(__m128 p) const {
+            const __m128 eased = _mm_mul_ps(_mm_mul_ps(p, p), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(p, p)));
+            return _mm_add_ps(_mm_set1_ps(from), _mm_mul_ps(_mm_set1_ps(to - from), eased));
+        }
+#endif
+    };
 };
 
 
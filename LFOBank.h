@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    LFOBank.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A bank of N LFOs sharing one sample rate, with their phases,
+    increments, waveforms and ranges stored as structure-of-arrays lanes.
+    process(n) moves every lane on n samples and works out all of their
+    values in one pass, four lanes at a time with SSE2, instead of each
+    modulated filter running its own LFO every sample.
+
+    Call process once per block (before the consumers), then each
+    consumer reads its lane, e.g.
+
+        bank.process(numSamples);
+        for(int i = 0; i < numAllpasses; i++) allpasses[i].processBlock(data, numSamples);
+
+    with each AllPassFilter given its lane via setModulationSource.
+
+    Lanes run the periodic LFO waveforms (sine, triangle, square, saw)
+    with LFO's values and conventions: the value after process(n) is
+    the one n calls to LFO::next() would end on.
+
+  ==============================================================================
+*/
+
+#ifndef LFOBank_h
+#define LFOBank_h
+
+#include <vector>
+#include "LFO.h"
+
+class LFOBank {
+public:
+
+    /**
+     Creates numLanes sine LFOs at 1Hz, mapped to 0 - 1.
+     All memory is allocated here, so construct it off the audio thread.
+     */
+    LFOBank(int numLanes, int sampleRate = 44100) {
+        jassert(numLanes > 0);
+        this->numLanes = numLanes;
+        this->sampleRate = sampleRate;
+        // pad the lane count so every SIMD group is full
+        laneStride = ((numLanes + laneWidth - 1) / laneWidth) * laneWidth;
+
+        progress.assign(laneStride, 0);
+        increments.assign(laneStride, 0);
+        phaseOffsets.assign(laneStride, 0);
+        frequencies.assign(laneStride, 1.0f);
+        types.assign(laneStride, LFO::SINE);
+        lows.assign(laneStride, 0.0f);
+        ranges.assign(laneStride, 1.0f);
+        values.assign(laneStride, 0.0f);
+
+        for(int lane = 0; lane < laneStride; lane++) {
+            updateIncrement(lane);
+        }
+        process(0);
+    }
+
+    ~LFOBank(){};
+
+    inline int getNumLanes() const {
+        return numLanes;
+    }
+
+    /**
+     Set the sample rate for every lane (keeping their frequencies).
+     */
+    inline void setSampleRate(int rate) {
+        sampleRate = rate;
+        for(int lane = 0; lane < laneStride; lane++) {
+            updateIncrement(lane);
+        }
+    }
+
+    /**
+     Sets the frequency of a lane in Hz.
+     */
+    inline void setFrequency(int lane, float frequency) {
+        jassert(lane >= 0 && lane < numLanes);
+        jassert(frequency > 0);
+        frequencies[lane] = frequency;
+        updateIncrement(lane);
+    }
+
+    /**
+     Sets the waveform of a lane (the periodic ones only).
+     */
+    inline void setType(int lane, LFO::Oscillator type) {
+        jassert(lane >= 0 && lane < numLanes);
+        jassert(type < LFO::RANDOM); // the random modes need an LFO of their own
+        types[lane] = type;
+    }
+
+    /**
+     Sets the phase of a lane (from 0 - 1), e.g. to spread
+     the lanes out.
+     */
+    inline void setPhase(int lane, float phase) {
+        jassert(lane >= 0 && lane < numLanes);
+        jassert(phase <= 1 && phase >= 0);
+        phaseOffsets[lane] = LFO::toFixedPoint(phase);
+    }
+
+    /**
+     Sets the range of values a lane returns.
+     */
+    inline void setRange(int lane, float min, float max) {
+        jassert(lane >= 0 && lane < numLanes);
+        lows[lane] = min;
+        ranges[lane] = max - min;
+    }
+
+    /**
+     Moves every lane on numSamples and updates all their values.
+     */
+    void process(int numSamples) {
+        for(int lane = 0; lane < laneStride; lane++) {
+            progress[lane] += (uint64_t) numSamples * increments[lane];
+        }
+
+        for(int g = 0; g < laneStride; g += laneWidth) {
+#if defined(PALDSP_LFO_SSE2)
+            const __m128i p01 = _mm_add_epi64(_mm_loadu_si128((const __m128i*) &progress[g]),
+                                              _mm_loadu_si128((const __m128i*) &phaseOffsets[g]));
+            const __m128i p23 = _mm_add_epi64(_mm_loadu_si128((const __m128i*) &progress[g + 2]),
+                                              _mm_loadu_si128((const __m128i*) &phaseOffsets[g + 2]));
+            const __m128 top01 = _mm_castsi128_ps(_mm_srli_epi64(p01, 40));
+            const __m128 top23 = _mm_castsi128_ps(_mm_srli_epi64(p23, 40));
+            const __m128i top = _mm_castps_si128(_mm_shuffle_ps(top01, top23, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128 p = _mm_mul_ps(_mm_cvtepi32_ps(top), _mm_set1_ps(1.0f / 16777216.0f));
+
+            // every waveform for every lane, then each lane picks its own
+            const __m128i type = _mm_loadu_si128((const __m128i*) &types[g]);
+            __m128 shape = LFO::SawShape::process(p);
+            shape = select(_mm_cmpeq_epi32(type, _mm_set1_epi32(LFO::SINE)), LFO::SineShape::process(p), shape);
+            shape = select(_mm_cmpeq_epi32(type, _mm_set1_epi32(LFO::TRIANGLE)), LFO::TriangleShape::process(p), shape);
+            shape = select(_mm_cmpeq_epi32(type, _mm_set1_epi32(LFO::SQUARE)), LFO::SquareShape::process(p), shape);
+
+            const __m128 y = _mm_add_ps(_mm_loadu_ps(&lows[g]), _mm_mul_ps(shape, _mm_loadu_ps(&ranges[g])));
+            _mm_storeu_ps(&values[g], y);
+#else
+            const float p = LFO::toProgress(progress[g] + phaseOffsets[g]);
+            float shape;
+            switch (types[g]) {
+                case LFO::SINE: shape = LFO::SineShape::process(p); break;
+                case LFO::TRIANGLE: shape = LFO::TriangleShape::process(p); break;
+                case LFO::SQUARE: shape = LFO::SquareShape::process(p); break;
+                default: shape = LFO::SawShape::process(p);
+            }
+            values[g] = lows[g] + shape * ranges[g];
+#endif
+        }
+    }
+
+    /**
+     Returns a lane's value (mapped to its range) as of the last process.
+     */
+    inline float getValue(int lane) const {
+        return values[lane];
+    }
+
+    /**
+     Returns every lane's value as of the last process.
+     */
+    inline const float* getValues() const {
+        return values.data();
+    }
+
+    /**
+     Sets every lane back to the start of its cycle.
+     */
+    inline void reset() {
+        std::fill(progress.begin(), progress.end(), 0);
+        process(0);
+    }
+
+private:
+#if defined(PALDSP_LFO_SSE2)
+    static constexpr int laneWidth = 4;
+#else
+    static constexpr int laneWidth = 1;
+#endif
+
+    int numLanes;
+    int laneStride; // numLanes rounded up to a multiple of laneWidth
+    int sampleRate;
+
+    // structure-of-arrays lane state
+    std::vector<uint64_t> progress, increments, phaseOffsets;
+    std::vector<float> frequencies;
+    std::vector<int32_t> types;
+    std::vector<float> lows, ranges;
+    std::vector<float> values;
+
+    inline void updateIncrement(int lane) {
+        jassert(frequencies[lane] < sampleRate);
+        increments[lane] = LFO::toFixedPoint((double) frequencies[lane] / sampleRate);
+    }
+
+#if defined(PALDSP_LFO_SSE2)
+    static inline __m128 select(__m128i mask, __m128 a, __m128 b) {
+        const __m128 m = _mm_castsi128_ps(mask);
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+#endif
+};
+
+
+#endif /* LFOBank_h */
@@ -27,20 +27,9 @@ public:
     
     LowShelfFilter(type filterType, float frequency, float Q, float dbGain, float wet = 1, float dry = 0) : Biquad (filterType, frequency, wet, dry) {
 
-        // audio-eq-cookbook
-        double w0 = 2 * (frequency/44100) * PI;
-        double cosW0 = cos(w0);
-        double sinW0 = sin(w0);
-        double alpha = sinW0 / (Q * 2);
-        double A = pow(10.0, dbGain/40);
-
-        // calculate coefficients
-        b0 = A * ((A + 1) - ((A - 1) * cosW0) + (2 * sqrt(A) * alpha));
-        b1 = 2 * A * ((A - 1) - ((A + 1) * cosW0));
-        b2 = A * ((A + 1) - ((A - 1) * cosW0) - (2 * sqrt(A) * alpha));
-        a0 = (A + 1) + ((A - 1) * cosW0) + (2 * sqrt(A) * alpha);
-        a1 = -2 * ((A - 1) + ((A + 1) * cosW0));
-        a2 = (A + 1) + ((A - 1) * cosW0) - (2 * sqrt(A) * alpha);
+        this->Q = Q;
+        this->dbGain = dbGain;
+        updateCoefficients();
     }
     
     inline float processSample(float samp){
@@ -51,10 +40,25 @@ public:
         else return 0.0f;
     }
 
+    using Biquad::processBlock;
+
+    void processBlock(const float* in, float* out, int numSamples) override {
+        if(filterType == BIQUAD) {
+            Biquad::processBlock(in, out, numSamples);
+        }
+        else std::fill_n(out, numSamples, 0.0f);
+    }
+
     void setType(int newType) {
         filterType = newType;
     }
 
+protected:
+    BiquadCoefficients designCoefficients() const override {
+        // audio-eq-cookbook
+        return BiquadCoefficients::lowShelf(freq, Q, dbGain, sampleRate);
+    }
+
 private:
 };
 
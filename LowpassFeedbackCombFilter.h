@@ -13,11 +13,16 @@
 #define LowpassFeedbackCombFilter_h
 
 #include "CircularBuffer.h"
+#include "Denormals.h"
 
 class LowpassFeedbackCombFilter {
 public:
-    LowpassFeedbackCombFilter(int delay, float feedbackGain, float damping){
-        buffer.setReadHeadDelay(delay);
+    /**
+     A lowpass feedback comb filter with a given delay length (in samples).
+     The delay memory is taken from the arena if one is given.
+     */
+    LowpassFeedbackCombFilter(int delay, float feedbackGain, float damping, DelayArena* arena = nullptr)
+        : buffer (delay, arena) {
         this->delay = delay;
         this->feedbackGain = feedbackGain;
         damp1 = damping;
@@ -36,17 +41,48 @@ public:
         // http://www.dreampoint.co.uk
         
         
-        float output = buffer.getSample();
-        // undenormalise may be necessary here
+        float output = flushDenormal(buffer.getSample());
         
-        filteredVal = (output * damp2) + (filteredVal * damp1);
-        // undenormalise may be necessary here
+        filteredVal = flushDenormal((output * damp2) + (filteredVal * damp1));
 
         buffer.pushSample(input + filteredVal * feedbackGain);
 
         return output;
     }
     
+    /**
+     Process a block of samples through the filter.
+     Works directly on the delay memory, in runs that don't wrap.
+     in and out may point to the same buffer.
+     */
+    inline void processBlock(const float* in, float* out, int numSamples) {
+        const float gain = feedbackGain;
+        const float d1 = damp1;
+        const float d2 = damp2;
+        float filtered = filteredVal;
+        
+        buffer.processSpans(numSamples, [&](const float* delayed, float* write, int offset, int n) {
+            const float* x = in + offset;
+            float* y = out + offset;
+            for(int i = 0; i < n; i++) {
+                const float input = x[i];
+                float output = flushDenormal(delayed[i]);
+                filtered = flushDenormal((output * d2) + (filtered * d1));
+                write[i] = input + filtered * gain;
+                y[i] = output;
+            }
+        });
+        
+        filteredVal = filtered;
+    }
+    
+    /**
+     Process a block of samples through the filter in place.
+     */
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+    
     /* Set length of delay line. */
     inline void setDelay(int delay) {
         this-> delay = delay;
@@ -85,7 +121,7 @@ private:
     CircularBuffer buffer { 1 }; // default buffer with length 1 sample
     int delay;
     float feedbackGain;
-    float filteredVal;
+    float filteredVal = 0;
     float damp1;
     float damp2;
 };
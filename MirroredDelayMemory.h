@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    MirroredDelayMemory.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Delay memory whose pages are mapped twice, back to back (Linux memfd).
+    Sample i and sample i + size are the same memory, so a read of up
+    to size samples from any start index in [0, size) is contiguous:
+    interpolated reads, multi-tap reads and block copies need no
+    wrapping at all. Use it as the Capacity of a PALdsp::CircularBuffer:
+
+        PALdsp::CircularBuffer<MirroredDelayMemory> delay (lengthSamples);
+
+    The size is a power of two, and at least one page (1024 floats).
+    If the mapping isn't available (other platforms, or mmap fails) it
+    quietly falls back to ordinary heap memory; isMirrored() reports
+    which, and the buffer uses masked access in that case.
+    Each line gets its own mapping, so DelayArena isn't used.
+
+  ==============================================================================
+*/
+
+#ifndef MirroredDelayMemory_h
+#define MirroredDelayMemory_h
+
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include "DelayArena.h"
+
+#if defined(__linux__)
+ #include <sys/mman.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #if defined(SYS_memfd_create)
+  #define PALDSP_HAS_MIRRORED_MEMORY 1
+ #endif
+#endif
+
+class MirroredDelayMemory {
+public:
+
+    MirroredDelayMemory(){}
+
+    /**
+     Allocates (cleared) storage for a delay of up to maxDelaySamples.
+     */
+    MirroredDelayMemory(int maxDelaySamples, DelayArena* arena = nullptr) {
+        allocate(maxDelaySamples, arena);
+    }
+
+    MirroredDelayMemory(const MirroredDelayMemory& other) {
+        copyFrom(other);
+    }
+
+    MirroredDelayMemory(MirroredDelayMemory&& other) noexcept {
+        moveFrom(other);
+    }
+
+    MirroredDelayMemory& operator=(const MirroredDelayMemory& other) {
+        if(this != &other) copyFrom(other);
+        return *this;
+    }
+
+    MirroredDelayMemory& operator=(MirroredDelayMemory&& other) noexcept {
+        if(this != &other) {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~MirroredDelayMemory() {
+        release();
+    }
+
+    /**
+     (Re)allocates cleared storage for a delay of up to maxDelaySamples.
+     The arena is ignored: each line is mapped separately.
+     Allocates, so call it off the audio thread.
+     */
+    void allocate(int maxDelaySamples, DelayArena* arena = nullptr) {
+        (void) arena;
+        release();
+        size = std::max(DelayArena::getDelayCapacity(maxDelaySamples), minimumSize);
+
+        if(! map()) {
+            // fallback: plain (unmirrored) memory
+            owned.assign(size, 0.0f);
+            data = owned.data();
+        }
+    }
+
+    /**
+     Sets all samples to 0
+     */
+    inline void clear() {
+        std::fill_n(data, size, 0.0f);
+    }
+
+    inline float& operator[](int index) {
+        return data[index];
+    }
+
+    inline const float& operator[](int index) const {
+        return data[index];
+    }
+
+    /**
+     The start of the memory. When mirrored, the 2 * size floats
+     from here are valid, the second half aliasing the first.
+     */
+    inline float* getData() {
+        return data;
+    }
+
+    /** The (power-of-two) number of samples. */
+    inline int getSize() const {
+        return size;
+    }
+
+    /** The mask for wire-and wrapping (size - 1). */
+    inline int getMask() const {
+        return size - 1;
+    }
+
+    /**
+     True if the double mapping succeeded; false if this
+     fell back to ordinary memory.
+     */
+    inline bool isMirrored() const {
+        return mapping != nullptr;
+    }
+
+private:
+    static constexpr int minimumSize = 1024; // one 4 KB page of floats
+
+    std::vector<float> owned;
+    float* data = nullptr;
+    void* mapping = nullptr; // the 2 * size region, when mirrored
+    int size = 0;
+
+    /**
+     Maps one memfd of size floats twice into a reserved region.
+     Returns false (with nothing left mapped) if anything fails.
+     memfd pages start zeroed, so there is nothing to clear.
+     */
+    bool map() {
+#if defined(PALDSP_HAS_MIRRORED_MEMORY)
+        const size_t bytes = (size_t) size * sizeof(float);
+        if(bytes % (size_t) sysconf(_SC_PAGESIZE) != 0) return false;
+
+        const int fd = (int) syscall(SYS_memfd_create, "PALdsp delay", 0);
+        if(fd < 0) return false;
+
+        void* region = MAP_FAILED;
+        if(ftruncate(fd, (off_t) bytes) == 0) {
+            // reserve the whole range, then map the file over both halves of it
+            region = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if(region != MAP_FAILED) {
+            char* first = (char*) region;
+            const bool mapped =
+                mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == first
+             && mmap(first + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == first + bytes;
+            if(! mapped) {
+                munmap(region, 2 * bytes);
+                region = MAP_FAILED;
+            }
+        }
+        close(fd); // the mappings keep the memory alive
+
+        if(region == MAP_FAILED) return false;
+        mapping = region;
+        data = (float*) region;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void release() {
+#if defined(PALDSP_HAS_MIRRORED_MEMORY)
+        if(mapping != nullptr) {
+            munmap(mapping, 2 * (size_t) size * sizeof(float));
+        }
+#endif
+        mapping = nullptr;
+        std::vector<float>().swap(owned);
+        data = nullptr;
+        size = 0;
+    }
+
+    void copyFrom(const MirroredDelayMemory& other) {
+        if(other.data == nullptr) {
+            release();
+            return;
+        }
+        allocate(other.size - 1);
+        memcpy(data, other.data, (size_t) size * sizeof(float));
+    }
+
+    void moveFrom(MirroredDelayMemory& other) {
+        const bool otherOwns = (other.mapping == nullptr);
+        owned = std::move(other.owned);
+        mapping = other.mapping;
+        data = otherOwns ? owned.data() : other.data;
+        size = other.size;
+        other.mapping = nullptr;
+        other.data = nullptr;
+        other.size = 0;
+    }
+};
+
+
+#endif /* MirroredDelayMemory_h */
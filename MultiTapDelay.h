@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    MultiTapDelay.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A delay line read by a table of fixed taps, each with its own delay
+    (whole or fractional samples) and gain, for early reflections and
+    multi-tap echoes.
+
+    Rather than reading every tap for every sample, each block is first
+    written into the delay memory, then each tap adds its whole block in
+    one pass: a tap's samples for a block are one contiguous run of the
+    memory (two if it wraps), so this is a plain multiply-add over
+    contiguous floats, 8 at a time with AVX or 4 at a time with SSE.
+    Fractional taps are linearly interpolated, with the gain folded into
+    the two weights when the tap is set; integer taps skip the second
+    read. A 32-tap reflection pattern is then 32 short vector loops per
+    block.
+
+    Taps are meant to be set up front and changed occasionally (a change
+    jumps); for a modulated read use PALdsp::CircularBuffer.
+
+  ==============================================================================
+*/
+
+#ifndef MultiTapDelay_h
+#define MultiTapDelay_h
+
+#include <vector>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "DelayMemory.h"
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define PALDSP_MULTITAPDELAY_SSE 1
+#endif
+
+class MultiTapDelay {
+public:
+
+    /**
+     Creates a delay with room for taps up to maxDelaySamples and up to
+     maxNumTaps taps. Longer blocks than maxBlockSize are split up.
+     All memory is allocated here (the delay memory from the arena if
+     one is given), so construct it off the audio thread.
+     */
+    MultiTapDelay(int maxDelaySamples, int maxNumTaps, int maxBlockSize = 512, DelayArena* arena = nullptr)
+        : memory (maxDelaySamples + 1 + maxBlockSize, arena) {
+        jassert(maxDelaySamples > 0 && maxNumTaps > 0 && maxBlockSize > 0);
+        this->maxDelay = maxDelaySamples;
+        this->maxBlockSize = maxBlockSize;
+
+        delays.reserve(maxNumTaps);
+        gains.reserve(maxNumTaps);
+        offsets.reserve(maxNumTaps);
+        weights0.reserve(maxNumTaps);
+        weights1.reserve(maxNumTaps);
+    }
+
+    ~MultiTapDelay(){};
+
+    /**
+     Adds a tap delaySamples behind the input (0 to the maximum delay,
+     may be fractional) and returns its index.
+     */
+    int addTap(float delaySamples, float gain) {
+        jassert(getNumTaps() < (int) delays.capacity()); // past maxNumTaps this would allocate
+        delays.push_back(0);
+        gains.push_back(0);
+        offsets.push_back(0);
+        weights0.push_back(0);
+        weights1.push_back(0);
+        setTap(getNumTaps() - 1, delaySamples, gain);
+        return getNumTaps() - 1;
+    }
+
+    /**
+     Changes the delay and gain of an existing tap.
+     */
+    inline void setTap(int index, float delaySamples, float gain) {
+        jassert(index >= 0 && index < getNumTaps());
+        jassert(delaySamples >= 0 && delaySamples <= maxDelay);
+        const int whole = (int) floorf(delaySamples);
+        const float frac = delaySamples - (float) whole;
+
+        delays[index] = delaySamples;
+        gains[index] = gain;
+        offsets[index] = whole;
+        // y = x[n - whole] * (1 - frac) + x[n - whole - 1] * frac
+        weights0[index] = gain * (1.0f - frac);
+        weights1[index] = gain * frac;
+    }
+
+    inline void setTapDelay(int index, float delaySamples) {
+        setTap(index, delaySamples, getTapGain(index));
+    }
+
+    inline void setTapGain(int index, float gain) {
+        setTap(index, getTapDelay(index), gain);
+    }
+
+    inline float getTapDelay(int index) {
+        return delays[index];
+    }
+
+    inline float getTapGain(int index) {
+        return gains[index];
+    }
+
+    inline int getNumTaps() {
+        return (int) delays.size();
+    }
+
+    /**
+     Removes all taps (keeping the delay memory).
+     */
+    inline void removeAllTaps() {
+        delays.clear();
+        gains.clear();
+        offsets.clear();
+        weights0.clear();
+        weights1.clear();
+    }
+
+    /**
+     Sets the delay memory to 0
+     */
+    inline void clear() {
+        memory.clear();
+    }
+
+    /**
+     Pushes numSamples from in and writes the sum of all taps to out.
+     in and out may be the same.
+     */
+    void processBlock(const float* in, float* out, int numSamples) {
+        for(int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(maxBlockSize, numSamples - start);
+            push(in + start, n);
+            std::fill_n(out + start, n, 0.0f);
+            for(int t = 0; t < getNumTaps(); t++) {
+                accumulateTap(out + start, t, n);
+            }
+            writeIndex = wrap(writeIndex + n);
+        }
+    }
+
+    /**
+     In-place version of the above.
+     */
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+
+    /**
+     Pushes numSamples from in and writes each tap (with its gain) to
+     its own output, tapOutputs[tap], e.g. to pan the taps separately.
+     The outputs must not overlap in.
+     */
+    void processBlock(const float* in, float* const* tapOutputs, int numSamples) {
+        for(int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(maxBlockSize, numSamples - start);
+            push(in + start, n);
+            for(int t = 0; t < getNumTaps(); t++) {
+                std::fill_n(tapOutputs[t] + start, n, 0.0f);
+                accumulateTap(tapOutputs[t] + start, t, n);
+            }
+            writeIndex = wrap(writeIndex + n);
+        }
+    }
+
+private:
+    DelayMemory memory;
+    int writeIndex = 0;
+    int maxDelay;
+    int maxBlockSize;
+
+    // the tap table, structure-of-arrays
+    std::vector<float> delays, gains;
+    std::vector<int> offsets;               // whole samples of delay
+    std::vector<float> weights0, weights1;  // gain * (1 - frac), gain * frac
+
+    /**
+     Copies a block into the memory at the write index
+     (which is advanced once the taps have been read).
+     */
+    inline void push(const float* in, int numSamples) {
+        const int firstSize = std::min(numSamples, memory.getSize() - writeIndex);
+        memcpy(memory.getData() + writeIndex, in, firstSize * sizeof(float));
+        memcpy(memory.getData(), in + firstSize, (numSamples - firstSize) * sizeof(float));
+    }
+
+    /**
+     Adds tap t's output for the block just pushed to out, a
+     contiguous run of the memory at a time.
+     */
+    inline void accumulateTap(float* out, int t, int numSamples) {
+        const float* x = memory.getData();
+        const float w0 = weights0[t];
+        const float w1 = weights1[t];
+        int position = wrap(writeIndex - offsets[t]);
+        int done = 0;
+        while(done < numSamples) {
+            if(w1 != 0 && position == 0) {
+                // the earlier sample is back at the end of the memory
+                out[done] += w0 * x[0] + w1 * x[memory.getSize() - 1];
+                position = 1;
+                done++;
+                continue;
+            }
+            const int n = std::min(numSamples - done, memory.getSize() - position);
+            if(w1 == 0) multiplyAdd(out + done, x + position, w0, n);
+            else multiplyAdd(out + done, x + position, w0, w1, n);
+            position = wrap(position + n);
+            done += n;
+        }
+    }
+
+    /**
+     out[i] += w0 * x[i]
+     */
+    static inline void multiplyAdd(float* out, const float* x, float w0, int numSamples) {
+        int i = 0;
+#if defined(__AVX__)
+        const __m256 v0 = _mm256_set1_ps(w0);
+        for(; i + 8 <= numSamples; i += 8) {
+            const __m256 y = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(v0, _mm256_loadu_ps(x + i)));
+            _mm256_storeu_ps(out + i, y);
+        }
+#elif defined(PALDSP_MULTITAPDELAY_SSE)
+        const __m128 v0 = _mm_set1_ps(w0);
+        for(; i + 4 <= numSamples; i += 4) {
+            const __m128 y = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(v0, _mm_loadu_ps(x + i)));
+            _mm_storeu_ps(out + i, y);
+        }
+#endif
+        for(; i < numSamples; i++) {
+            out[i] += w0 * x[i];
+        }
+    }
+
+    /**
+     out[i] += w0 * x[i] + w1 * x[i - 1]
+     */
+    static inline void multiplyAdd(float* out, const float* x, float w0, float w1, int numSamples) {
+        int i = 0;
+#if defined(__AVX__)
+        const __m256 v0 = _mm256_set1_ps(w0);
+        const __m256 v1 = _mm256_set1_ps(w1);
+        for(; i + 8 <= numSamples; i += 8) {
+            const __m256 taps = _mm256_add_ps(_mm256_mul_ps(v0, _mm256_loadu_ps(x + i)),
+                                              _mm256_mul_ps(v1, _mm256_loadu_ps(x + i - 1)));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), taps));
+        }
+#elif defined(PALDSP_MULTITAPDELAY_SSE)
+        const __m128 v0 = _mm_set1_ps(w0);
+        const __m128 v1 = _mm_set1_ps(w1);
+        for(; i + 4 <= numSamples; i += 4) {
+            const __m128 taps = _mm_add_ps(_mm_mul_ps(v0, _mm_loadu_ps(x + i)),
+                                           _mm_mul_ps(v1, _mm_loadu_ps(x + i - 1)));
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), taps));
+        }
+#endif
+        for(; i < numSamples; i++) {
+            out[i] += w0 * x[i] + w1 * x[i - 1];
+        }
+    }
+
+    inline int wrap(int value) {
+        return value & memory.getMask();
+    }
+};
+
+
+#endif /* MultiTapDelay_h */
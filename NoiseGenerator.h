@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A small, realtime-safe source of white and pink noise (and random
+    numbers in general) for modulation and audio.
+
+    Numbers come from four xorshift32 generators run side by side as
+    SIMD lanes; sample i of the stream comes from lane i % 4. A block
+    is made four samples per step with SSE2, and the scalar path steps
+    the lanes the same way, so a given seed always gives the same
+    stream (whichever calls are used, on any platform).
+    Each default-constructed generator gets its own seed (in order of
+    construction), so separate generators are uncorrelated; use
+    setSeed() for repeatable results.
+
+    White noise is uniform from -1 to 1. Pink noise is white noise
+    through Paul Kellet's refined pinking filter (within 0.05 dB of
+    -3 dB/octave above about 10 Hz at 44.1 kHz), scaled to roughly
+    -1 to 1.
+
+  ==============================================================================
+*/
+
+#ifndef NoiseGenerator_h
+#define NoiseGenerator_h
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define PALDSP_NOISEGENERATOR_SSE2 1
+#endif
+
+class NoiseGenerator {
+public:
+
+    /**
+     Creates a generator with a seed no other default-constructed
+     generator has had.
+     */
+    NoiseGenerator() : NoiseGenerator (makeUniqueSeed()) {}
+
+    /**
+     Creates a generator with a given seed.
+     */
+    NoiseGenerator(uint32_t seed) {
+        setSeed(seed);
+    }
+
+    ~NoiseGenerator(){};
+
+    /**
+     Restarts the stream for a given seed and clears the pink filter.
+     */
+    void setSeed(uint32_t seed) {
+        for(int lane = 0; lane < numLanes; lane++) {
+            // splitmix32-style scramble of (seed, lane); xorshift needs a non-zero state
+            uint32_t z = seed * 4u + (uint32_t) lane + 0x9e3779b9u;
+            z = (z ^ (z >> 16)) * 0x85ebca6bu;
+            z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+            z ^= z >> 16;
+            state[lane] = (z != 0) ? z : 0x6d2b79f5u;
+        }
+        position = numLanes; // nothing buffered
+        for(auto& b : pinkState) b = 0;
+    }
+
+    /**
+     Returns the next white noise sample (-1 to 1).
+     */
+    inline float nextWhite() {
+        if(position == numLanes) {
+            step(buffered);
+            position = 0;
+        }
+        return buffered[position++];
+    }
+
+    /**
+     Returns the next pink noise sample (roughly -1 to 1).
+     */
+    inline float nextPink() {
+        return pink(nextWhite());
+    }
+
+    /**
+     Fills out with the next numSamples white noise samples,
+     four at a time.
+     */
+    void nextWhiteBlock(float* out, int numSamples) {
+        int i = 0;
+        // use up anything buffered by nextWhite first
+        while(i < numSamples && position < numLanes) {
+            out[i++] = buffered[position++];
+        }
+        for(; i + numLanes <= numSamples; i += numLanes) {
+            step(out + i);
+        }
+        for(; i < numSamples; i++) {
+            out[i] = nextWhite();
+        }
+    }
+
+    /**
+     Fills out with the next numSamples pink noise samples.
+     */
+    void nextPinkBlock(float* out, int numSamples) {
+        nextWhiteBlock(out, numSamples);
+        for(int i = 0; i < numSamples; i++) {
+            out[i] = pink(out[i]);
+        }
+    }
+
+private:
+    static constexpr int numLanes = 4;
+
+    uint32_t state[numLanes];
+    float buffered[numLanes];
+    int position;
+    float pinkState[7];
+
+    static uint32_t makeUniqueSeed() {
+        static std::atomic<uint32_t> counter { 0 };
+        return ++counter;
+    }
+
+    /**
+     Advances every lane once, writing one sample per lane: the
+     top 23 bits as a float in [1, 2), then moved to [-1, 1).
+     */
+    inline void step(float* out) {
+#if defined(PALDSP_NOISEGENERATOR_SSE2)
+        __m128i s = _mm_loadu_si128((const __m128i*) state);
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+        s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+        _mm_storeu_si128((__m128i*) state, s);
+        const __m128i bits = _mm_or_si128(_mm_srli_epi32(s, 9), _mm_set1_epi32(0x3f800000));
+        const __m128 oneToTwo = _mm_castsi128_ps(bits);
+        _mm_storeu_ps(out, _mm_sub_ps(_mm_add_ps(oneToTwo, oneToTwo), _mm_set1_ps(3.0f)));
+#else
+        for(int lane = 0; lane < numLanes; lane++) {
+            uint32_t s = state[lane];
+            s ^= s << 13;
+            s ^= s >> 17;
+            s ^= s << 5;
+            state[lane] = s;
+            const uint32_t bits = (s >> 9) | 0x3f800000u;
+            float oneToTwo;
+            memcpy(&oneToTwo, &bits, sizeof(float));
+            out[lane] = (oneToTwo + oneToTwo) - 3.0f;
+        }
+#endif
+    }
+
+    /**
+     Paul Kellet's refined pinking filter (a sum of one-poles).
+     */
+    inline float pink(float white) {
+        float* b = pinkState;
+        b[0] = 0.99886f * b[0] + white * 0.0555179f;
+        b[1] = 0.99332f * b[1] + white * 0.0750759f;
+        b[2] = 0.96900f * b[2] + white * 0.1538520f;
+        b[3] = 0.86650f * b[3] + white * 0.3104856f;
+        b[4] = 0.55000f * b[4] + white * 0.5329522f;
+        b[5] = -0.7616f * b[5] - white * 0.0168980f;
+        const float out = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + white * 0.5362f;
+        b[6] = white * 0.115926f;
+        return out * 0.11f;
+    }
+};
+
+
+#endif /* NoiseGenerator_h */
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    Oversampler.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    2x / 4x / 8x oversampling built from cascaded polyphase half-band
+    stages (see HalfbandFilter.h). Wraps a nonlinear processor so that it
+    runs at the higher rate and its aliasing is filtered out on the way
+    back down. The first stage (nearest the host rate) is the steepest,
+    and later stages get shorter because they have more transition band.
+
+    e.g. oversampling a BitCrush:
+
+        Oversampler os (4, maxBlockSize);
+        os.processSamples(data, numSamples, [&](float s) { return crusher.crush(s); });
+        os.processBlock(data, numSamples, [&](float* d, int n) { crusher.desample(d, n); });
+
+    getLatency() reports the added delay in host-rate samples (possibly
+    fractional), for plugin latency reporting or dry-path alignment.
+
+  ==============================================================================
+*/
+
+#ifndef Oversampler_h
+#define Oversampler_h
+
+#include <vector>
+#include <memory>
+#include "HalfbandFilter.h"
+
+class Oversampler {
+public:
+
+    /**
+     Creates an oversampler.
+     Allocates all buffers, so construct it off the audio thread.
+     @param factor The oversampling factor (2, 4 or 8).
+     @param maxBlockSize The largest host block that will be processed.
+     @param firstStagePairs Coefficient pairs in the first stage (quality).
+     */
+    Oversampler(int factor, int maxBlockSize, int firstStagePairs = 16) {
+        jassert(factor == 2 || factor == 4 || factor == 8);
+        jassert(maxBlockSize > 0);
+
+        this->factor = factor;
+        this->maxBlockSize = maxBlockSize;
+
+        numStages = 0;
+        while((1 << numStages) < factor) numStages++;
+
+        int pairs = firstStagePairs;
+        int rate = 1;
+        latency = 0;
+        for(int s = 0; s < numStages; s++) {
+            stages.emplace_back(new HalfbandFilter(pairs));
+            buffers.emplace_back(maxBlockSize * (2 << s), 0.0f);
+            // latency at this stage's input rate, in host samples
+            latency += (float) stages.back()->getLatency() / (float) rate;
+            rate *= 2;
+            pairs = std::max(4, pairs / 2);
+        }
+    }
+
+    ~Oversampler(){};
+
+    inline int getFactor() {
+        return factor;
+    }
+
+    /**
+     Added latency in host-rate samples.
+     */
+    inline float getLatency() {
+        return latency;
+    }
+
+    void reset() {
+        for(auto& stage : stages) stage->reset();
+    }
+
+    /**
+     Upsamples a block into the internal buffer and returns it.
+     The returned buffer holds numSamples * getFactor() samples.
+     */
+    float* upsample(const float* in, int numSamples) {
+        jassert(numSamples <= maxBlockSize);
+        const float* src = in;
+        int n = numSamples;
+        for(int s = 0; s < numStages; s++) {
+            stages[s]->upsample(src, buffers[s].data(), n);
+            src = buffers[s].data();
+            n *= 2;
+        }
+        return buffers[numStages - 1].data();
+    }
+
+    /**
+     Downsamples the internal buffer (as returned by upsample) back to
+     numSamples host-rate samples.
+     */
+    void downsample(float* out, int numSamples) {
+        jassert(numSamples <= maxBlockSize);
+        int n = numSamples << (numStages - 1);
+        for(int s = numStages - 1; s > 0; s--) {
+            // each stage writes into the buffer of the rate below it
+            stages[s]->downsample(buffers[s].data(), buffers[s - 1].data(), n);
+            n /= 2;
+        }
+        stages[0]->downsample(buffers[0].data(), out, numSamples);
+    }
+
+    /**
+     Runs a per-sample processor (float -> float) at the oversampled rate,
+     in place on data.
+     */
+    template <typename Processor>
+    void processSamples(float* data, int numSamples, Processor&& processor) {
+        for(int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(maxBlockSize, numSamples - start);
+            float* os = upsample(data + start, n);
+            const int osN = n * factor;
+            for(int i = 0; i < osN; i++) {
+                os[i] = processor(os[i]);
+            }
+            downsample(data + start, n);
+        }
+    }
+
+    /**
+     Runs a block processor (void(float* data, int numSamples)) at the
+     oversampled rate, in place on data.
+     */
+    template <typename Processor>
+    void processBlock(float* data, int numSamples, Processor&& processor) {
+        for(int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(maxBlockSize, numSamples - start);
+            float* os = upsample(data + start, n);
+            processor(os, n * factor);
+            downsample(data + start, n);
+        }
+    }
+
+private:
+    int factor;
+    int maxBlockSize;
+    int numStages;
+    float latency;
+    std::vector<std::unique_ptr<HalfbandFilter>> stages;
+    std::vector<std::vector<float>> buffers; // output of each up stage
+};
+
+
+#endif /* Oversampler_h */
@@ -1,19 +1,41 @@
 
 #include "AllPassFilter.h"
+#include "AudioFifo.h"
+#include "BandLimitedOscillator.h"
 #include "Biquad.h"
+#include "BiquadBank.h"
+#include "BiquadCoefficients.h"
+#include "BiquadCore.h"
 #include "BitCrush.h"
 #include "BPF.h"
 #include "CircularBuffer.h"
 #include "CircularBufferLong.h"
 #include "CircularBufferShort.h"
+#include "Convolver.h"
+#include "DelayArena.h"
+#include "DelayFeedback.h"
+#include "DelayInterpolation.h"
+#include "DelayMemory.h"
+#include "Denormals.h"
 #include "FeedbackCombFilter.h"
 #include "filter.h"
 #include "Gain.h"
+#include "HalfbandFilter.h"
 #include "HighShelfFilter.h"
 #include "HPF.h"
 #include "LFO.h"
+#include "LFOBank.h"
 #include "LowpassFeedbackCombFilter.h"
 #include "LowShelfFilter.h"
 #include "LPF.h"
+#include "MirroredDelayMemory.h"
+#include "MultiTapDelay.h"
+#include "NoiseGenerator.h"
 #include "NotchFilter.h"
+#include "Oversampler.h"
 #include "ParamEQBand.h"
+#include "RealFFT.h"
+#include "Resampler.h"
+#include "StateVariableFilter.h"
+#include "StaticFilters.h"
+#include "UniformConvolver.h"
@@ -28,19 +28,9 @@ public:
     // constructor with default coefficients
     ParamEQBand(type filterType, float frequency, float Q, float dbGain, float wet = 1, float dry = 0) : Biquad (filterType, frequency, wet, dry) {
 
-        double w0 = 2 * (frequency/44100) * PI;
-        double cosW0 = cos(w0);
-        double sinW0 = sin(w0);
-        double alpha = sinW0 / (Q * 2);
-        double A = pow(10.0, dbGain/40);
-
-        // calculate coefficients
-        b0 = 1 + (alpha * A);
-        b1 = -2 * cosW0;
-        b2 = 1 - (alpha * A);
-        a0 = 1 + (alpha / A);
-        a1 = -2 * cosW0;
-        a2 = 1 - (alpha / A);
+        this->Q = Q;
+        this->dbGain = dbGain;
+        updateCoefficients();
     }
     
     inline float processSample(float samp){
@@ -50,10 +40,25 @@ public:
         else return 0.0f;
     }
 
+    using Biquad::processBlock;
+
+    void processBlock(const float* in, float* out, int numSamples) override {
+        if(filterType == BIQUAD) {
+            Biquad::processBlock(in, out, numSamples);
+        }
+        else std::fill_n(out, numSamples, 0.0f);
+    }
+
     void setType(int newType) {
         filterType = newType;
     }
 
+protected:
+    BiquadCoefficients designCoefficients() const override {
+        // audio-eq-cookbook
+        return BiquadCoefficients::peaking(freq, Q, dbGain, sampleRate);
+    }
+
 private:
 };
 
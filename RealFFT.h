@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    RealFFT.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A small, allocation-free (after construction) real-input FFT for
+    power-of-two sizes. A size-N real transform is done as a size-N/2
+    complex radix-2 FFT plus a split step, so it costs about half of a
+    complex FFT of the same length.
+
+    Spectra are stored split (separate real and imaginary arrays) with
+    N/2 + 1 bins, which keeps spectral multiply-adds vectorisable.
+
+  ==============================================================================
+*/
+
+#ifndef RealFFT_h
+#define RealFFT_h
+
+#include <math.h>
+#include <vector>
+
+#ifndef PI
+#define PI      3.14159265358979323846
+#endif
+
+class RealFFT {
+public:
+
+    /**
+     Creates an FFT of the given size (a power of two, at least 4).
+     All tables are allocated here.
+     */
+    RealFFT(int size) {
+        jassert(size >= 4 && (size & (size - 1)) == 0);
+        fftSize = size;
+        half = size / 2;
+
+        // bit-reversal table for the half-size complex FFT
+        bitReverse.resize(half);
+        int bits = 0;
+        while((1 << bits) < half) bits++;
+        for(int i = 0; i < half; i++) {
+            int r = 0;
+            for(int b = 0; b < bits; b++) {
+                if(i & (1 << b)) r |= 1 << (bits - 1 - b);
+            }
+            bitReverse[i] = r;
+        }
+
+        // twiddles for the complex FFT (exp(-2*pi*i*k/half))
+        twiddleRe.resize(half / 2 > 0 ? half / 2 : 1);
+        twiddleIm.resize(twiddleRe.size());
+        for(int k = 0; k < half / 2; k++) {
+            twiddleRe[k] = (float) cos(-2.0 * PI * k / half);
+            twiddleIm[k] = (float) sin(-2.0 * PI * k / half);
+        }
+
+        // twiddles for the real split step (exp(-2*pi*i*k/size))
+        splitRe.resize(half + 1);
+        splitIm.resize(half + 1);
+        for(int k = 0; k <= half; k++) {
+            splitRe[k] = (float) cos(-2.0 * PI * k / size);
+            splitIm[k] = (float) sin(-2.0 * PI * k / size);
+        }
+
+        workRe.resize(half);
+        workIm.resize(half);
+    }
+
+    ~RealFFT(){};
+
+    inline int getSize() {
+        return fftSize;
+    }
+
+    /** Number of bins in a spectrum (size / 2 + 1). */
+    inline int getNumBins() {
+        return half + 1;
+    }
+
+    /**
+     Forward transform of size real samples.
+     @param in The input signal (size samples).
+     @param outRe Real parts of the size/2 + 1 bins.
+     @param outIm Imaginary parts of the size/2 + 1 bins.
+     */
+    void performForward(const float* in, float* outRe, float* outIm) {
+        // pack even/odd samples as one complex signal, in bit-reversed order
+        for(int n = 0; n < half; n++) {
+            const int r = bitReverse[n];
+            workRe[r] = in[2 * n];
+            workIm[r] = in[2 * n + 1];
+        }
+
+        complexTransform(false);
+
+        // split into the spectrum of the real signal
+        const float zr0 = workRe[0], zi0 = workIm[0];
+        outRe[0] = zr0 + zi0;
+        outIm[0] = 0;
+        outRe[half] = zr0 - zi0;
+        outIm[half] = 0;
+
+        for(int k = 1; k < half; k++) {
+            const float ar = workRe[k], ai = workIm[k];
+            const float br = workRe[half - k], bi = -workIm[half - k]; // conj(Z[half - k])
+            // E = (Z[k] + conj(Z[half-k])) / 2, O = (Z[k] - conj(Z[half-k])) / 2i
+            const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+            const float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+            const float wr = splitRe[k], wi = splitIm[k];
+            outRe[k] = er + (wr * or_ - wi * oi);
+            outIm[k] = ei + (wr * oi + wi * or_);
+        }
+    }
+
+    /**
+     Inverse transform back to size real samples (scaled, so
+     performInverse(performForward(x)) == x).
+     */
+    void performInverse(const float* inRe, const float* inIm, float* out) {
+        for(int k = 0; k < half; k++) {
+            const float ar = inRe[k], ai = inIm[k];
+            const float br = inRe[half - k], bi = -inIm[half - k]; // conj(X[half - k])
+            // E = (X[k] + conj(X[half-k])) / 2, O = (X[k] - conj(X[half-k])) / (2 W^k)
+            const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+            const float dr = 0.5f * (ar - br), di = 0.5f * (ai - bi);
+            const float wr = splitRe[k], wi = -splitIm[k]; // 1/W^k = conj(W^k)
+            const float or_ = dr * wr - di * wi;
+            const float oi = dr * wi + di * wr;
+            // Z = E + iO, stored bit-reversed for the inverse FFT
+            const int r = bitReverse[k];
+            workRe[r] = er - oi;
+            workIm[r] = ei + or_;
+        }
+
+        complexTransform(true);
+
+        const float scale = 1.0f / (float) half;
+        for(int n = 0; n < half; n++) {
+            out[2 * n] = workRe[n] * scale;
+            out[2 * n + 1] = workIm[n] * scale;
+        }
+    }
+
+private:
+    int fftSize;
+    int half;
+    std::vector<int> bitReverse;
+    std::vector<float> twiddleRe, twiddleIm;
+    std::vector<float> splitRe, splitIm;
+    std::vector<float> workRe, workIm;
+
+    /**
+     In-place iterative radix-2 FFT on the (already bit-reversed) work arrays.
+     */
+    void complexTransform(bool inverse) {
+        const float sign = inverse ? -1.0f : 1.0f;
+
+        for(int len = 2; len <= half; len <<= 1) {
+            const int halfLen = len >> 1;
+            const int step = half / len;
+            for(int start = 0; start < half; start += len) {
+                for(int j = 0; j < halfLen; j++) {
+                    const float wr = twiddleRe[j * step];
+                    const float wi = sign * twiddleIm[j * step];
+                    const int a = start + j;
+                    const int b = a + halfLen;
+                    const float tr = workRe[b] * wr - workIm[b] * wi;
+                    const float ti = workRe[b] * wi + workIm[b] * wr;
+                    workRe[b] = workRe[a] - tr;
+                    workIm[b] = workIm[a] - ti;
+                    workRe[a] += tr;
+                    workIm[a] += ti;
+                }
+            }
+        }
+    }
+};
+
+
+#endif /* RealFFT_h */
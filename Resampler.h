@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+    Resampler.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    A streaming polyphase sample-rate converter for any rational ratio,
+    e.g. to run a graph designed for 44.1kHz (the default of the biquads
+    and the fixed-length circular buffers) from a 32, 48 or 96kHz host,
+    or to bring files and streams at those rates into it.
+
+    The ratio outputRate / inputRate is reduced to L / M. Conceptually
+    the input is upsampled by L, lowpassed with a Kaiser-windowed sinc
+    and downsampled by M; in practice each output is one row of the
+    filter (one of L phases) applied to the last few input samples, so
+    only the outputs that are kept are computed and no multiplies are
+    spent on zero-stuffed samples. Each output is one contiguous dot
+    product, 8 or 4 taps at a time with AVX or SSE.
+
+    The quality setting picks the taps per phase and the stopband
+    attenuation; the stopband starts at the lower of the two Nyquist
+    frequencies, so nothing aliases into the output:
+
+        LOW     32 taps,  70 dB, flat to about 0.73 * Nyquist
+        MEDIUM  64 taps, 100 dB, flat to about 0.80 * Nyquist
+        HIGH   128 taps, 120 dB, flat to about 0.88 * Nyquist
+        BEST   256 taps, 140 dB, flat to about 0.93 * Nyquist
+
+    (taps are scaled up by M / L when downsampling, to keep the same
+    response at the lower rate).
+
+    process() takes any number of input samples and returns however
+    many outputs they complete. In fixed-latency mode (processFixed) it
+    instead writes exactly the number of outputs asked for, from a
+    short queue primed with silence, e.g. on the way back up to a
+    host's block size. Either way the latency is a whole number of
+    output samples (the first output phase is chosen to make it so).
+
+    The filter table is shared between copies, so for several channels
+    make one resampler and copy it.
+
+  ==============================================================================
+*/
+
+#ifndef Resampler_h
+#define Resampler_h
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "HalfbandFilter.h"
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define PALDSP_RESAMPLER_SSE 1
+#endif
+
+class Resampler {
+public:
+
+    enum Quality {
+        LOW,
+        MEDIUM,
+        HIGH,
+        BEST
+    };
+
+    /**
+     Creates a converter from inputRate to outputRate (in Hz).
+     Blocks to processFixed may be up to maxBlockSize input samples
+     (process splits longer ones).
+     Builds the filter table and allocates everything, so construct it
+     off the audio thread.
+     */
+    Resampler(int inputRate, int outputRate, int maxBlockSize = 512, Quality quality = HIGH) {
+        jassert(inputRate > 0 && outputRate > 0 && maxBlockSize > 0);
+        const int divisor = gcd(inputRate, outputRate);
+        L = outputRate / divisor;
+        M = inputRate / divisor;
+        jassert(L <= 4096); // the table holds L phases; reduce the ratio first
+        this->maxBlockSize = maxBlockSize;
+
+        static const int baseTaps[] = { 32, 64, 128, 256 };
+        static const double attenuation[] = { 70, 100, 120, 140 };
+
+        // more taps when downsampling, so the transition band is the same at the output rate
+        const double scale = std::max(1.0, (double) M / (double) L);
+        numTaps = ((int) ceil(baseTaps[quality] * scale) + 7) & ~7;
+        coefficients = makeTable(L, M, numTaps, attenuation[quality]);
+
+        // the prototype is centred on tap D = numTaps * L / 2 - 1; starting the
+        // output phase at D mod M makes the delay a whole D / M output samples
+        const int64_t centre = (int64_t) numTaps * L / 2 - 1;
+        startPhase = (int) (centre % M);
+        latency = (int) (centre / M);
+        primeSamples = (L + M - 1) / M + 2;
+
+        history.assign(numTaps - 1 + maxBlockSize, 0.0f);
+        queue.assign(2 * primeSamples + getMaxOutputSamples(maxBlockSize), 0.0f);
+        reset();
+    }
+
+    ~Resampler(){};
+
+    inline int getInputRateFactor() {
+        return M;
+    }
+
+    inline int getOutputRateFactor() {
+        return L;
+    }
+
+    inline int getNumTaps() {
+        return numTaps;
+    }
+
+    /**
+     Latency of process() in output samples.
+     */
+    inline int getLatency() {
+        return latency;
+    }
+
+    /**
+     Latency of processFixed() in output samples.
+     */
+    inline int getFixedLatency() {
+        return latency + primeSamples;
+    }
+
+    /**
+     The most outputs numInputSamples can produce from process().
+     */
+    inline int getMaxOutputSamples(int numInputSamples) {
+        return (int) (((int64_t) numInputSamples * L) / M) + 1;
+    }
+
+    /**
+     Clears the history and the fixed-latency queue.
+     */
+    void reset() {
+        std::fill(history.begin(), history.end(), 0.0f);
+        phase = startPhase;
+        std::fill(queue.begin(), queue.end(), 0.0f);
+        queued = primeSamples;
+    }
+
+    /**
+     Converts numSamples inputs, writing the outputs they complete to out
+     (which needs room for getMaxOutputSamples(numSamples)), and returns
+     how many were written.
+     */
+    int process(const float* in, int numSamples, float* out) {
+        const float* table = coefficients->data();
+        float* x = history.data();
+        int numOut = 0;
+        for(int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(maxBlockSize, numSamples - start);
+            // the block goes after the last numTaps - 1 inputs, so input i's
+            // window is the numTaps samples from x + i (oldest first)
+            memcpy(x + numTaps - 1, in + start, n * sizeof(float));
+            for(int i = 0; i < n; i++) {
+                // every output that falls before the next input
+                while(phase < L) {
+                    out[numOut++] = dotProduct(table + (size_t) phase * numTaps, x + i, numTaps);
+                    phase += M;
+                }
+                phase -= L;
+            }
+            memmove(x, x + n, (numTaps - 1) * sizeof(float));
+        }
+        return numOut;
+    }
+
+    /**
+     Fixed-latency mode: converts numSamples inputs (up to maxBlockSize)
+     and writes exactly numOutputs outputs, delayed by getFixedLatency().
+     The outputs asked for over time should follow the rate ratio (give
+     or take a sample a block), e.g. the host's block size when the
+     inputs come from a graph fed by another Resampler.
+     */
+    void processFixed(const float* in, int numSamples, float* out, int numOutputs) {
+        jassert(numSamples <= maxBlockSize);
+        const int room = (int) queue.size() - getMaxOutputSamples(numSamples);
+        if(queued > room) {
+            // asked for fewer outputs than the ratio gives; drop the oldest rather than overflow
+            jassertfalse;
+            memmove(queue.data(), queue.data() + (queued - room), room * sizeof(float));
+            queued = room;
+        }
+        queued += process(in, numSamples, queue.data() + queued);
+
+        const int available = std::min(numOutputs, queued);
+        jassert(available == numOutputs); // asked for more than the ratio allows
+        memcpy(out, queue.data(), available * sizeof(float));
+        std::fill(out + available, out + numOutputs, 0.0f);
+
+        queued -= available;
+        memmove(queue.data(), queue.data() + available, queued * sizeof(float));
+    }
+
+private:
+    int L; // output rate factor (phases)
+    int M; // input rate factor (step between outputs, in phases)
+    int numTaps; // taps per phase, a multiple of 8
+    int maxBlockSize;
+    int latency;
+    int startPhase;
+    int primeSamples; // silence at the front of the fixed-latency queue
+
+    // phase p's taps are at p * numTaps, ordered oldest input first
+    std::shared_ptr<const std::vector<float>> coefficients;
+
+    // the last numTaps - 1 inputs, then room for a block; written a block
+    // at a time (rather than a sample at a time, as HalfbandFilter does) so
+    // the vector loads never wait on a just-stored sample
+    std::vector<float> history;
+    int phase; // of the next output, in 1 / L input samples past the newest input
+
+    std::vector<float> queue; // fixed-latency outputs not yet taken
+    int queued;
+
+    static int gcd(int a, int b) {
+        while(b != 0) {
+            const int t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    /**
+     The sum of a[i] * b[i] (n a multiple of 8). Four running sums, so
+     the adds don't wait on each other.
+     */
+    static inline float dotProduct(const float* a, const float* b, int n) {
+        int i = 0;
+#if defined(__AVX__)
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        for(; i + 32 <= n; i += 32) {
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24)));
+        }
+        for(; i < n; i += 8) {
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        const __m256 sum = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+#elif defined(PALDSP_RESAMPLER_SSE)
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        __m128 sum2 = _mm_setzero_ps();
+        __m128 sum3 = _mm_setzero_ps();
+        for(; i + 16 <= n; i += 16) {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+            sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+        }
+        if(i < n) {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 s = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+#else
+        float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for(; i < n; i += 4) {
+            sum0 += a[i] * b[i];
+            sum1 += a[i + 1] * b[i + 1];
+            sum2 += a[i + 2] * b[i + 2];
+            sum3 += a[i + 3] * b[i + 3];
+        }
+        return (sum0 + sum1) + (sum2 + sum3);
+#endif
+    }
+
+    /**
+     Designs the L-phase lowpass (a Kaiser-windowed sinc with its stopband
+     from the lower Nyquist frequency) and splits it into its phases.
+     */
+    static std::shared_ptr<const std::vector<float>> makeTable(int L, int M, int numTaps, double attenuation) {
+        const int length = numTaps * L;
+        const double centre = length / 2 - 1; // the last tap is left at 0 so the centre is whole
+        const double beta = 0.1102 * (attenuation - 8.7);
+
+        // transition width (radians per sample at the lower rate), from Kaiser's formula
+        const int slower = std::max(L, M);
+        const double transition = (attenuation - 8.0) / (2.285 * numTaps * L) * slower;
+        const double cutoff = (0.5 - transition / (4.0 * PI)) / slower; // cycles per upsampled sample
+
+        std::vector<double> prototype(length, 0.0);
+        for(int k = 0; k < length - 1; k++) {
+            const double t = k - centre;
+            const double sinc = (t == 0) ? 1.0 : sin(2.0 * PI * cutoff * t) / (2.0 * PI * cutoff * t);
+            prototype[k] = 2.0 * cutoff * sinc * HalfbandFilter::kaiser(t / (centre + 1), beta);
+        }
+
+        auto table = std::make_shared<std::vector<float>>((size_t) length);
+        for(int p = 0; p < L; p++) {
+            // each phase sums to 1, so DC passes at unity whatever the phase
+            double sum = 0;
+            for(int j = 0; j < numTaps; j++) sum += prototype[p + j * L];
+            for(int j = 0; j < numTaps; j++) {
+                // tap j of the row multiplies the input (numTaps - 1 - j) samples back
+                (*table)[(size_t) p * numTaps + j] = (float) (prototype[p + (numTaps - 1 - j) * L] / sum);
+            }
+        }
+        return table;
+    }
+};
+
+
+#endif /* Resampler_h */
@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+    StateVariableFilter.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Topology-preserving transform (TPT) state variable filter, giving
+    lowpass, highpass, bandpass (0dB peak, like BPF) and notch outputs
+    at the same time.
+    Unlike the direct-form biquads it stays stable and click-free when the
+    cutoff is modulated every sample, and its coefficient only needs a
+    tan() (done here with a rational approximation) rather than a full
+    cookbook redesign.
+
+    Equations from: V. Zavalishin, The Art of VA Filter Design (ch.4)
+
+  ==============================================================================
+*/
+
+#include "filter.h"
+#include "Denormals.h"
+
+#ifndef StateVariableFilter_h
+#define StateVariableFilter_h
+#include <math.h>
+#include <algorithm>
+
+#ifndef PI
+#define PI      3.14159265358979323846
+#endif
+
+class StateVariableFilter : public filter {
+public:
+
+    enum type {
+        LOWPASS,
+        HIGHPASS,
+        BANDPASS,
+        NOTCH
+    };
+
+    StateVariableFilter(type filterType, float frequency, float Q, float wet = 1, float dry = 0) : filter (filterType, frequency, wet, dry) {
+        setQ(Q);
+        setFrequency(frequency);
+    }
+
+    virtual ~StateVariableFilter() {}
+
+    /**
+     Processes a sample through the filter at the current cutoff,
+     returning the output selected by filterType.
+     */
+    inline float processSample(float samp) {
+        float lp, hp, bp;
+        tick(samp, g, h, lp, hp, bp);
+        return (selectOutput(filterType, samp, lp, hp, bp) * wet) + (samp * dry);
+    }
+
+    /**
+     Processes a sample at the current cutoff and returns all four
+     responses at once.
+     */
+    inline void processSample(float samp, float& lowpass, float& highpass, float& bandpass, float& notch) {
+        float bp;
+        tick(samp, g, h, lowpass, highpass, bp);
+        bandpass = twoR * bp;
+        notch = samp - bandpass;
+    }
+
+    using filter::processBlock;
+
+    /**
+     Processes a block at the current cutoff frequency.
+     */
+    void processBlock(const float* in, float* out, int numSamples) override {
+        const int mode = filterType;
+        const float gain = g, norm = h;
+        const float wetGain = wet, dryGain = dry;
+
+        for(int i = 0; i < numSamples; i++) {
+            const float samp = in[i];
+            float lp, hp, bp;
+            tick(samp, gain, norm, lp, hp, bp);
+            out[i] = (selectOutput(mode, samp, lp, hp, bp) * wetGain) + (samp * dryGain);
+        }
+
+        flushState();
+    }
+
+    /**
+     Processes a block with a per-sample cutoff frequency (in Hz),
+     e.g. a block of LFO output mapped to a frequency range.
+     The cutoff is clamped to just below Nyquist.
+     @param in The input samples.
+     @param out The output buffer (may be the same as in).
+     @param cutoffHz One cutoff frequency per sample.
+     @param numSamples The number of samples to process.
+     */
+    inline void processBlock(const float* in, float* out, const float* cutoffHz, int numSamples) {
+        const int mode = filterType;
+        const float wetGain = wet, dryGain = dry;
+        const float r2 = twoR;
+        const float piOverFs = (float) (PI / sampleRate);
+        const float maxCutoff = (float) (maxCutoffRatio * sampleRate);
+
+        for(int i = 0; i < numSamples; i++) {
+            const float samp = in[i];
+            const float gain = fastTan(piOverFs * std::min(std::max(cutoffHz[i], 0.0f), maxCutoff));
+            const float norm = 1.0f / (1.0f + (r2 * gain) + (gain * gain));
+            float lp, hp, bp;
+            tick(samp, gain, norm, lp, hp, bp);
+            out[i] = (selectOutput(mode, samp, lp, hp, bp) * wetGain) + (samp * dryGain);
+        }
+
+        if(numSamples > 0) freq = std::min(std::max(cutoffHz[numSamples - 1], 0.0f), maxCutoff);
+        updateCoefficient();
+        flushState();
+    }
+
+    /**
+     Processes a block and writes all four responses.
+     Any output pointer may be nullptr if that response isn't needed.
+     @param cutoffHz Per-sample cutoff in Hz, or nullptr to use the current cutoff.
+     */
+    inline void processBlock(const float* in, float* lowpassOut, float* highpassOut,
+                             float* bandpassOut, float* notchOut, const float* cutoffHz, int numSamples) {
+        const float r2 = twoR;
+        const float piOverFs = (float) (PI / sampleRate);
+        const float maxCutoff = (float) (maxCutoffRatio * sampleRate);
+        float gain = g, norm = h;
+
+        for(int i = 0; i < numSamples; i++) {
+            if(cutoffHz != nullptr) {
+                gain = fastTan(piOverFs * std::min(std::max(cutoffHz[i], 0.0f), maxCutoff));
+                norm = 1.0f / (1.0f + (r2 * gain) + (gain * gain));
+            }
+            const float samp = in[i];
+            float lp, hp, bp;
+            tick(samp, gain, norm, lp, hp, bp);
+            if(lowpassOut != nullptr) lowpassOut[i] = lp;
+            if(highpassOut != nullptr) highpassOut[i] = hp;
+            if(bandpassOut != nullptr) bandpassOut[i] = r2 * bp;
+            if(notchOut != nullptr) notchOut[i] = samp - (r2 * bp);
+        }
+
+        flushState();
+
+        if(cutoffHz != nullptr && numSamples > 0) {
+            freq = std::min(std::max(cutoffHz[numSamples - 1], 0.0f), maxCutoff);
+            updateCoefficient();
+        }
+    }
+
+    void setType(int newType) {
+        filterType = newType;
+    }
+
+    void prepare(double newSampleRate) override {
+        sampleRate = newSampleRate;
+        updateCoefficient();
+    }
+
+    /**
+     Sets the cutoff frequency in Hz. Cheap enough to call every sample.
+     */
+    inline void setFrequency(float frequency) {
+        freq = frequency;
+        updateCoefficient();
+    }
+
+    /**
+     Sets the resonance of the filter (Q > 0).
+     */
+    inline void setQ(float newQ) {
+        jassert(newQ > 0);
+        Q = newQ;
+        twoR = 1.0f / Q;
+        updateCoefficient();
+    }
+
+    float getFrequency() { return freq; }
+    float getQ() { return Q; }
+
+    void reset() {
+        s1 = 0;
+        s2 = 0;
+    }
+
+    /**
+     Rational (Pade 7/6) approximation of tan(x), accurate to ~1e-7
+     up to 0.49 * PI; used to prewarp the cutoff without calling tan().
+     */
+    static inline float fastTan(float x) {
+        const float x2 = x * x;
+        const float num = x * (135135.0f - x2 * (17325.0f - x2 * (378.0f - x2)));
+        const float den = 135135.0f - x2 * (62370.0f - x2 * (3150.0f - (28.0f * x2)));
+        return num / den;
+    }
+
+private:
+    static constexpr double maxCutoffRatio = 0.49; // of the sample rate
+
+    float Q = 0.7071f;
+    float twoR = 1.4142f; // damping (2R = 1/Q)
+    float g = 0;          // prewarped cutoff gain
+    float h = 1;          // 1 / (1 + 2Rg + g^2)
+    // integrator states
+    float s1 = 0;
+    float s2 = 0;
+
+    inline void flushState() {
+        s1 = flushDenormal(s1);
+        s2 = flushDenormal(s2);
+    }
+
+    inline void updateCoefficient() {
+        const double cutoff = std::min(std::max((double) freq, 0.0), maxCutoffRatio * sampleRate);
+        g = fastTan((float) (PI * cutoff / sampleRate));
+        h = 1.0f / (1.0f + (twoR * g) + (g * g));
+    }
+
+    /**
+     One step of the TPT SVF with the given coefficients.
+     */
+    inline void tick(float x, float gain, float norm, float& lp, float& hp, float& bp) {
+        hp = (x - ((twoR + gain) * s1) - s2) * norm;
+        const float v1 = gain * hp;
+        bp = v1 + s1;
+        s1 = bp + v1;
+        const float v2 = gain * bp;
+        lp = v2 + s2;
+        s2 = lp + v2;
+    }
+
+    inline float selectOutput(int mode, float x, float lp, float hp, float bp) {
+        switch (mode) {
+            case LOWPASS:
+                return lp;
+            case HIGHPASS:
+                return hp;
+            case BANDPASS:
+                return twoR * bp;
+            case NOTCH:
+                return x - (twoR * bp);
+            default:
+                return 0.0f;
+        }
+    }
+};
+
+
+#endif /* StateVariableFilter_h */
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+    StaticFilters.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Compile-time specialised lowpass/highpass filters.
+    The filter type is a template tag rather than a runtime int, and nothing
+    is virtual, so processSample() can be inlined into a caller's loop:
+
+        PALdsp::LPF<PALdsp::FirstOrder> smoother;
+        PALdsp::HPF<PALdsp::Biquad> dcBlock (20.0f, 0.7071f);
+
+    The runtime LPF/HPF classes (filter/Biquad subclasses) use these as
+    their kernels, for code that needs to switch type at runtime.
+    NB: the tags live in the PALdsp namespace, so qualify them rather than
+    relying on 'using namespace PALdsp' (the global Biquad class would clash).
+
+  ==============================================================================
+*/
+
+#ifndef StaticFilters_h
+#define StaticFilters_h
+
+#include "BiquadCoefficients.h"
+#include "BiquadCore.h"
+
+namespace PALdsp {
+
+    // filter type tags
+    struct FirstOrder {};
+    struct Biquad {};
+
+    template <typename Type> class LPF;
+    template <typename Type> class HPF;
+
+    /**
+     Shared parameter handling and processing for the static biquad variants.
+     Coefficients are redesigned lazily, once, at the next block after a setter.
+     */
+    template <typename Derived>
+    class StaticBiquad {
+    public:
+        typedef PALDSP_BIQUAD_SAMPLE_TYPE SampleType;
+
+        StaticBiquad(float frequency, float Q, float wet, float dry) {
+            this->freq = frequency;
+            this->Q = Q;
+            this->wet = wet;
+            this->dry = dry;
+        }
+
+        inline float processSample(float samp) {
+            if(coefficientsDirty) updateCoefficients();
+            SampleType result = core.processSample(samp);
+            return (float) ((result * wet) + (samp * dry));
+        }
+
+        inline void processBlock(const float* in, float* out, int numSamples) {
+            if(coefficientsDirty) updateCoefficients();
+
+            const float wetGain = wet;
+            const float dryGain = dry;
+
+            for(int i = 0; i < numSamples; i++) {
+                const float samp = in[i];
+                SampleType result = core.processSample(samp);
+                out[i] = (float) ((result * wetGain) + (samp * dryGain));
+            }
+
+            core.flushState();
+        }
+
+        inline void processBlock(float* data, int numSamples) {
+            processBlock(data, data, numSamples);
+        }
+
+        void prepare(double newSampleRate) {
+            sampleRate = newSampleRate;
+            coefficientsDirty = true;
+        }
+
+        void setFrequency(float frequency) {
+            freq = frequency;
+            coefficientsDirty = true;
+        }
+
+        void setQ(float newQ) {
+            Q = newQ;
+            coefficientsDirty = true;
+        }
+
+        void setWet(float gain) { wet = gain; }
+        void setDry(float gain) { dry = gain; }
+
+        void reset() {
+            core.reset();
+        }
+
+        void updateCoefficients() {
+            core.setCoefficients(Derived::design(freq, Q, sampleRate));
+            coefficientsDirty = false;
+        }
+
+    protected:
+        BiquadCore<SampleType, PALDSP_BIQUAD_TOPOLOGY> core;
+        float freq;
+        float Q;
+        float wet;
+        float dry;
+        double sampleRate = 44100;
+        bool coefficientsDirty = true;
+    };
+
+    /**
+     First-order lowpass: a two-point average with a hard-set bandwidth.
+     */
+    template <>
+    class LPF<FirstOrder> {
+    public:
+        LPF() {}
+
+        inline float processSample(float samp) {
+            float result = (0.5f * samp) + (delay * bandWidth);
+            delay = samp;
+            return result;
+        }
+
+        inline void processBlock(const float* in, float* out, int numSamples) {
+            const double gain = bandWidth;
+            double z = delay;
+            for(int i = 0; i < numSamples; i++) {
+                const float samp = in[i];
+                out[i] = (float) ((0.5f * samp) + (z * gain));
+                z = samp;
+            }
+            delay = z;
+        }
+
+        inline void processBlock(float* data, int numSamples) {
+            processBlock(data, data, numSamples);
+        }
+
+        void reset() {
+            delay = 0;
+        }
+
+    private:
+        double delay = 0;
+        double bandWidth = 0.5; // hard-set bandwidth for now
+    };
+
+    /**
+     Cookbook biquad lowpass.
+     */
+    template <>
+    class LPF<Biquad> : public StaticBiquad<LPF<Biquad>> {
+    public:
+        LPF(float frequency, float Q, float wet = 1, float dry = 0) : StaticBiquad(frequency, Q, wet, dry) {}
+
+        static BiquadCoefficients design(float frequency, float Q, double sampleRate) {
+            return BiquadCoefficients::lowpass(frequency, Q, sampleRate);
+        }
+    };
+
+    /**
+     First-order highpass with a hard-set bandwidth.
+     */
+    template <>
+    class HPF<FirstOrder> {
+    public:
+        HPF() {}
+
+        inline float processSample(float samp) {
+            float result = ((1 + bandWidth) / 2) * (samp - delayDry) + delayWet;
+            delayDry = samp;
+            delayWet = result;
+            return result;
+        }
+
+        inline void processBlock(const float* in, float* out, int numSamples) {
+            const double gain = (1 + bandWidth) / 2;
+            double zDry = delayDry;
+            double zWet = delayWet;
+            for(int i = 0; i < numSamples; i++) {
+                const float samp = in[i];
+                const float result = gain * (samp - zDry) + zWet;
+                zDry = samp;
+                zWet = result;
+                out[i] = result;
+            }
+            delayDry = zDry;
+            delayWet = zWet;
+        }
+
+        inline void processBlock(float* data, int numSamples) {
+            processBlock(data, data, numSamples);
+        }
+
+        void reset() {
+            delayDry = 0;
+            delayWet = 0;
+        }
+
+    private:
+        double delayDry = 0;
+        double delayWet = 0;
+        double bandWidth = 1;
+    };
+
+    /**
+     Cookbook biquad highpass.
+     */
+    template <>
+    class HPF<Biquad> : public StaticBiquad<HPF<Biquad>> {
+    public:
+        HPF(float frequency, float Q, float wet = 1, float dry = 0) : StaticBiquad(frequency, Q, wet, dry) {}
+
+        static BiquadCoefficients design(float frequency, float Q, double sampleRate) {
+            return BiquadCoefficients::highpass(frequency, Q, sampleRate);
+        }
+    };
+}
+
+
+#endif /* StaticFilters_h */
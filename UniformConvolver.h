@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    UniformConvolver.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Uniformly partitioned overlap-save FFT convolution (UPOLS).
+    The impulse response is split into blocks of blockSize samples, each
+    transformed once at construction. Incoming audio is transformed one
+    block at a time into a frequency-domain delay line (FDL), and every
+    output block is a single multiply-add pass over the FDL followed by
+    one inverse FFT.
+
+    The FDL is a ring of spectra indexed with Pirkle's wire-anded
+    wrapping, the same way CircularBuffer indexes its samples.
+
+    Latency is exactly blockSize samples. Audio can be passed in blocks of
+    any size; the FFT work happens whenever blockSize new samples have
+    arrived.
+
+  ==============================================================================
+*/
+
+#ifndef UniformConvolver_h
+#define UniformConvolver_h
+
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include "RealFFT.h"
+
+class UniformConvolver {
+public:
+
+    /**
+     Creates a convolver for the given impulse response.
+     All memory is allocated and the IR is transformed here,
+     so construct it off the audio thread.
+     @param impulseResponse The IR samples.
+     @param irLength The number of IR samples.
+     @param blockSize The partition size (a power of two); also the latency.
+     */
+    UniformConvolver(const float* impulseResponse, int irLength, int blockSize) : fft (blockSize * 2) {
+        jassert(irLength > 0);
+        jassert(blockSize > 1 && (blockSize & (blockSize - 1)) == 0);
+
+        this->blockSize = blockSize;
+        fftSize = blockSize * 2;
+        numBins = blockSize + 1;
+        numPartitions = (irLength + blockSize - 1) / blockSize;
+
+        // round the FDL up to a power of two so it can wrap with a mask
+        fdlSize = 1;
+        while(fdlSize < numPartitions) fdlSize <<= 1;
+        fdlMask = fdlSize - 1;
+
+        irRe.assign(numPartitions * numBins, 0.0f);
+        irIm.assign(numPartitions * numBins, 0.0f);
+        fdlRe.assign(fdlSize * numBins, 0.0f);
+        fdlIm.assign(fdlSize * numBins, 0.0f);
+        accRe.assign(numBins, 0.0f);
+        accIm.assign(numBins, 0.0f);
+        inputFrame.assign(fftSize, 0.0f);
+        timeBuffer.assign(fftSize, 0.0f);
+        outputBlock.assign(blockSize, 0.0f);
+
+        // transform each zero-padded IR partition
+        for(int p = 0; p < numPartitions; p++) {
+            std::fill(timeBuffer.begin(), timeBuffer.end(), 0.0f);
+            const int start = p * blockSize;
+            const int len = std::min(blockSize, irLength - start);
+            std::copy_n(impulseResponse + start, len, timeBuffer.begin());
+            fft.performForward(timeBuffer.data(), &irRe[p * numBins], &irIm[p * numBins]);
+        }
+    }
+
+    ~UniformConvolver(){};
+
+    /**
+     Convolves a block of samples. in and out may be the same buffer.
+     */
+    void processBlock(const float* in, float* out, int numSamples) {
+        int done = 0;
+        while(done < numSamples) {
+            const int n = std::min(numSamples - done, blockSize - bufferPos);
+
+            // stash the input first, so in-place processing is safe
+            memcpy(&inputFrame[blockSize + bufferPos], in + done, n * sizeof(float));
+            memcpy(out + done, &outputBlock[bufferPos], n * sizeof(float));
+
+            bufferPos += n;
+            done += n;
+
+            if(bufferPos == blockSize) {
+                processPartition();
+                bufferPos = 0;
+            }
+        }
+    }
+
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+
+    /**
+     Clears all audio history (the IR is kept).
+     */
+    void reset() {
+        std::fill(fdlRe.begin(), fdlRe.end(), 0.0f);
+        std::fill(fdlIm.begin(), fdlIm.end(), 0.0f);
+        std::fill(inputFrame.begin(), inputFrame.end(), 0.0f);
+        std::fill(outputBlock.begin(), outputBlock.end(), 0.0f);
+        bufferPos = 0;
+        fdlIndex = 0;
+    }
+
+    /** Latency in samples (equal to the block size). */
+    inline int getLatency() {
+        return blockSize;
+    }
+
+    inline int getBlockSize() {
+        return blockSize;
+    }
+
+    inline int getNumPartitions() {
+        return numPartitions;
+    }
+
+private:
+    RealFFT fft;
+    int blockSize;
+    int fftSize;
+    int numBins;
+    int numPartitions;
+    int fdlSize;
+    int fdlMask; // for wire-and wrapping of the FDL
+    int fdlIndex = 0;
+    int bufferPos = 0;
+
+    std::vector<float> irRe, irIm;    // IR partition spectra
+    std::vector<float> fdlRe, fdlIm;  // frequency-domain delay line
+    std::vector<float> accRe, accIm;  // output spectrum accumulator
+    std::vector<float> inputFrame;    // [previous block | current block]
+    std::vector<float> timeBuffer;
+    std::vector<float> outputBlock;   // output being played out
+
+    /**
+     Transforms the newest input block into the FDL and computes the
+     next block of output.
+     */
+    void processPartition() {
+        fft.performForward(inputFrame.data(), &fdlRe[fdlIndex * numBins], &fdlIm[fdlIndex * numBins]);
+
+        std::fill(accRe.begin(), accRe.end(), 0.0f);
+        std::fill(accIm.begin(), accIm.end(), 0.0f);
+
+        float* ar = accRe.data();
+        float* ai = accIm.data();
+        for(int p = 0; p < numPartitions; p++) {
+            const int slot = (fdlIndex - p) & fdlMask;
+            const float* xr = &fdlRe[slot * numBins];
+            const float* xi = &fdlIm[slot * numBins];
+            const float* hr = &irRe[p * numBins];
+            const float* hi = &irIm[p * numBins];
+            for(int k = 0; k < numBins; k++) {
+                ar[k] += (xr[k] * hr[k]) - (xi[k] * hi[k]);
+                ai[k] += (xr[k] * hi[k]) + (xi[k] * hr[k]);
+            }
+        }
+
+        fft.performInverse(ar, ai, timeBuffer.data());
+
+        // overlap-save: the second half is the valid output
+        std::copy_n(timeBuffer.begin() + blockSize, blockSize, outputBlock.begin());
+        // slide the input frame along by one block
+        std::copy_n(inputFrame.begin() + blockSize, blockSize, inputFrame.begin());
+
+        fdlIndex = (fdlIndex + 1) & fdlMask;
+    }
+};
+
+
+#endif /* UniformConvolver_h */
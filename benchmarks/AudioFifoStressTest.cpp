@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    AudioFifoStressTest.cpp
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Two-thread stress test and throughput benchmark for AudioFifo.
+
+    A producer thread writes a counting sequence in random-sized chunks
+    (through both write() and prepareWrite/finishWrite) while a consumer
+    reads random-sized chunks (through read() and prepareRead/finishRead)
+    and checks that every sample arrives once, in order. The chunk
+    sizes are random, so transfers keep straddling the end of the
+    memory and both spans are exercised. Build with -fsanitize=thread
+    to have the memory ordering checked as well.
+
+    Then the same transfer with fixed 512-sample blocks is timed.
+    Either side yields when the FIFO is full (or empty), so this also
+    runs on a single core, if slowly.
+
+        g++ -std=c++17 -O2 -I. benchmarks/AudioFifoStressTest.cpp -pthread
+
+  ==============================================================================
+*/
+
+#include "BenchmarkSupport.h"
+#include "../AudioFifo.h"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+static float valueAt(long position) {
+    return (float) (position % 1000003); // exact in a float
+}
+
+/** Fills spans with the sequence from position; returns how many were filled. */
+static int fill(const PALdsp::DelaySpans& spans, long position) {
+    for(int i = 0; i < spans.first.size; i++) spans.first.data[i] = valueAt(position + i);
+    for(int i = 0; i < spans.second.size; i++) spans.second.data[i] = valueAt(position + spans.first.size + i);
+    return spans.first.size + spans.second.size;
+}
+
+static bool stress(long total, int capacity) {
+    AudioFifo fifo (capacity);
+    std::atomic<bool> inOrder { true };
+
+    std::thread producer ([&] {
+        std::mt19937 random (1);
+        std::vector<float> chunk (capacity + 100);
+        long position = 0;
+        while(position < total) {
+            const int wanted = (int) std::min<long>(random() % chunk.size(), total - position);
+            int written;
+            if(random() & 1) {
+                for(int i = 0; i < wanted; i++) chunk[i] = valueAt(position + i);
+                written = fifo.write(chunk.data(), wanted);
+            }
+            else {
+                written = fill(fifo.prepareWrite(wanted), position);
+                fifo.finishWrite(written);
+            }
+            position += written;
+            if(written == 0) std::this_thread::yield();
+        }
+    });
+
+    std::thread consumer ([&] {
+        std::mt19937 random (2);
+        std::vector<float> chunk (capacity + 100);
+        long position = 0;
+        while(position < total) {
+            const int wanted = (int) (random() % chunk.size());
+            int numRead;
+            if(random() & 1) {
+                numRead = fifo.read(chunk.data(), wanted);
+                for(int i = 0; i < numRead; i++) {
+                    if(chunk[i] != valueAt(position + i)) inOrder = false;
+                }
+            }
+            else {
+                const PALdsp::DelaySpans spans = fifo.prepareRead(wanted);
+                for(int i = 0; i < spans.first.size; i++) {
+                    if(spans.first.data[i] != valueAt(position + i)) inOrder = false;
+                }
+                for(int i = 0; i < spans.second.size; i++) {
+                    if(spans.second.data[i] != valueAt(position + spans.first.size + i)) inOrder = false;
+                }
+                numRead = spans.first.size + spans.second.size;
+                fifo.finishRead(numRead);
+            }
+            position += numRead;
+            if(numRead == 0) std::this_thread::yield();
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    return inOrder && fifo.getNumReady() == 0;
+}
+
+static double throughput(long total, int capacity, int blockSize) {
+    AudioFifo fifo (capacity);
+    return benchmark::nanosPerItem(total, 3, [&] {
+        std::thread producer ([&] {
+            std::vector<float> block (blockSize, 0.5f);
+            for(long position = 0; position < total;) {
+                const int written = fifo.write(block.data(), blockSize);
+                position += written;
+                if(written == 0) std::this_thread::yield();
+            }
+        });
+        std::vector<float> block (blockSize);
+        for(long position = 0; position < total;) {
+            const int numRead = fifo.read(block.data(), blockSize);
+            position += numRead;
+            if(numRead == 0) std::this_thread::yield();
+        }
+        producer.join();
+        benchmark::keep(block[0]);
+    });
+}
+
+int main() {
+    for(int capacity : { 1000, 4096, 100000 }) {
+        benchmark::check(stress(20000000, capacity), "samples arrived out of order or were lost");
+        std::printf("stress, capacity %d: OK\n", capacity);
+    }
+
+    const long total = 20000000;
+    for(int capacity : { 2048, 16384 }) {
+        std::printf("throughput, capacity %d, 512-sample blocks: %.3f ns/sample\n",
+                    capacity, throughput(total, capacity, 512));
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    BenchmarkSupport.h
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Shared bits for the standalone benchmarks and stress tests in this
+    folder. Each is a single source file built against the library
+    headers, e.g. from the repository root:
+
+        g++ -std=c++17 -O2 -march=native -I. benchmarks/AudioFifoStressTest.cpp -pthread
+
+    Outside a JUCE project the few JUCE pieces the headers use
+    (jassert, jassertfalse, jmap) are stood in for here.
+
+    Timings are wall-clock and only indicative: run on a quiet machine
+    and compare numbers from the same run.
+
+  ==============================================================================
+*/
+
+#ifndef BenchmarkSupport_h
+#define BenchmarkSupport_h
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#if ! defined(JUCE_CORE_H_INCLUDED)
+ #define jassert(expression) assert(expression)
+ #define jassertfalse assert(false)
+namespace juce {
+    template <typename Type>
+    Type jmap(Type value, Type targetMin, Type targetMax) {
+        return targetMin + value * (targetMax - targetMin);
+    }
+}
+#endif
+
+#if defined(_MSC_VER)
+ #define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+ #define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace benchmark {
+
+/**
+ Runs function() repeats times and returns the fastest run in
+ nanoseconds per item, for runs of itemsPerRun items.
+ */
+template <typename Function>
+double nanosPerItem(long itemsPerRun, int repeats, Function&& function) {
+    double best = 1e30;
+    for(int r = 0; r < repeats; r++) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        const double nanos = std::chrono::duration<double, std::nano>(end - start).count();
+        best = (nanos < best) ? nanos : best;
+    }
+    return best / (double) itemsPerRun;
+}
+
+/**
+ Keeps a result alive so the work producing it isn't optimised away.
+ */
+inline void keep(float value) {
+    static volatile float sink;
+    sink = value;
+    (void) sink;
+}
+
+/**
+ Reports a failed check and exits non-zero.
+ */
+inline void check(bool condition, const char* what) {
+    if(! condition) {
+        std::printf("FAILED: %s\n", what);
+        std::exit(1);
+    }
+}
+
+}
+
+#endif /* BenchmarkSupport_h */
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    MirroredDelayBenchmark.cpp
+    Created: 16 Oct 2026
+    Author:  Peter Liley
+
+    Mirrored (double-mapped) delay memory against ordinary masked memory.
+
+    - Modulated reads: getSample with a swept read-head offset, for
+      several interpolation kernels. Masked memory gathers the kernel's
+      taps through wrap() one by one; mirrored memory reads them in place.
+    - Block copies: readBlock/pushBlock pairs of 64 samples on a delay
+      of 3000 samples, which keep straddling the end of the memory
+      (two memcpys each with masked memory, one with mirrored).
+
+    Both kinds of memory are checked to give the same output first.
+    Mirroring needs Linux; elsewhere both rows are the masked path.
+
+        g++ -std=c++17 -O2 -march=native -I. benchmarks/MirroredDelayBenchmark.cpp
+
+  ==============================================================================
+*/
+
+#include "BenchmarkSupport.h"
+#include "../PALdsp.h"
+#include <vector>
+
+static const int numSamples = 2000000;
+
+template <typename Memory, typename Interpolation>
+static double modulatedReads(std::vector<float>* output) {
+    PALdsp::CircularBuffer<Memory, Interpolation> delay (1000, 20);
+    float sum = 0;
+    const double nanos = benchmark::nanosPerItem(numSamples, 3, [&] {
+        for(int i = 0; i < numSamples; i++) {
+            delay.setReadHeadModulation(10.0f * (float) (i & 4095) / 4096.0f);
+            const float y = delay.getSample();
+            delay.pushSample((float) (i & 255));
+            sum += y;
+            if(output != nullptr && (int) output->size() < 10000) output->push_back(y);
+        }
+    });
+    benchmark::keep(sum);
+    return nanos;
+}
+
+template <typename Memory>
+static double blockCopies() {
+    PALdsp::CircularBuffer<Memory> delay (3000);
+    float block[64];
+    for(int i = 0; i < 64; i++) block[i] = (float) i;
+    return benchmark::nanosPerItem(numSamples, 3, [&] {
+        for(int i = 0; i < numSamples; i += 64) {
+            delay.readBlock(block, 64);
+            delay.pushBlock(block, 64);
+        }
+        benchmark::keep(block[0]);
+    });
+}
+
+template <typename Interpolation>
+static void compare(const char* name) {
+    std::vector<float> masked, mirrored;
+    const double maskedNanos = modulatedReads<DelayMemory, Interpolation>(&masked);
+    const double mirroredNanos = modulatedReads<MirroredDelayMemory, Interpolation>(&mirrored);
+    benchmark::check(masked == mirrored, "mirrored memory gives different output");
+    std::printf("%-28s %8.2f %10.2f %8.2fx\n", name, maskedNanos, mirroredNanos, maskedNanos / mirroredNanos);
+}
+
+int main() {
+    MirroredDelayMemory probe (1024);
+    std::printf("mirrored mapping %s\n\n", probe.isMirrored() ? "in use" : "NOT available (both use masking)");
+
+    std::printf("ns/sample                      masked   mirrored  speedup\n");
+    using namespace DelayInterpolation;
+    compare<Linear>("modulated read, linear");
+    compare<Hermite>("modulated read, hermite");
+    compare<Lagrange6>("modulated read, lagrange6");
+    compare<WindowedSinc<16>>("modulated read, sinc16");
+
+    const double maskedNanos = blockCopies<DelayMemory>();
+    const double mirroredNanos = blockCopies<MirroredDelayMemory>();
+    std::printf("%-28s %8.2f %10.2f %8.2fx\n", "64-sample block copies", maskedNanos, mirroredNanos, maskedNanos / mirroredNanos);
+    return 0;
+}
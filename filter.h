@@ -32,8 +32,46 @@ public:
      * @return float The processed sample
      */
     virtual inline float processSample(float samp) = 0;
+    
+    /**
+     * @brief Processes a block of samples through this filter.
+     * Subclasses override this to keep the per-sample work out of
+     * the virtual call, so there is one indirect call per block.
+     * 
+     * @param in Pointer to the first input sample.
+     * @param out Pointer to the output buffer (may be the same as in).
+     * @param numSamples The number of samples to process.
+     */
+    virtual void processBlock(const float* in, float* out, int numSamples) {
+        for(int i = 0; i < numSamples; i++) {
+            out[i] = processSample(in[i]);
+        }
+    }
+    
+    /**
+     * @brief Processes a block of samples through this filter in place.
+     * 
+     * @param data Pointer to the first sample of the buffer.
+     * @param numSamples The number of samples to process.
+     */
+    inline void processBlock(float* data, int numSamples) {
+        processBlock(data, data, numSamples);
+    }
+    
     virtual void setType(int newType) = 0;
     
+    /**
+     * @brief Tells the filter the sample rate it will be run at.
+     * Call this from prepareToPlay (or equivalent) before processing.
+     * 
+     * @param newSampleRate The host sample rate in Hz.
+     */
+    virtual void prepare(double newSampleRate) {
+        sampleRate = newSampleRate;
+    }
+    
+    double getSampleRate() { return sampleRate; }
+    
     void setWet(float gain) {
         jassert(gain <= 1 && gain >= 0);
         wet = gain;
@@ -53,6 +91,7 @@ protected:
     float freq;
     float wet;
     float dry;
+    double sampleRate = 44100;
 };
 
 